@@ -0,0 +1,398 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <atomic>
+#include <latch>
+#include <cmath>
+#include <ctime>
+#include <algorithm>
+#include <functional>
+#include "Thread_Pool.h"
+#include "Blocking_Queue.h"
+#include "Lock_Free_Queue.h"
+#include "Concurrent_LRU_Cache.h"
+#include "Striped_Unordered_Map.h"
+#include "Latency_Histogram.h"
+
+using Clock = std::chrono::steady_clock;
+
+static std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+struct Config {
+    std::vector<int> threads{1, 2, 4, 8};
+    std::vector<std::string> distributions{"uniform", "zipf"};
+    std::vector<double> read_ratios{0.5, 0.9, 0.99};
+    std::vector<std::string> benchmarks{"Thread_Pool", "BlockingQueue", "Lock_Free_Queue", "Concurrent_LRU", "Striped_UM"};
+    std::size_t ops = 200000;            // per thread (per producer for queues)
+    std::size_t keys = 100000;
+    double zipf_theta = 0.99;
+    std::string out;
+};
+
+struct Result {
+    std::string benchmark;
+    int threads = 0;
+    std::string distribution;            // empty for queues and the pool
+    double read_ratio = -1;
+    std::uint64_t ops = 0;
+    double seconds = 0;
+    Latency_Histogram latency;
+};
+
+// Zipfian generator from Gray et al., "Quickly Generating Billion-Record
+// Synthetic Databases" (the one YCSB uses), valid for 0 < theta < 1. Rank 0
+// is the hottest key.
+class Zipf_Generator {
+public:
+    Zipf_Generator(std::uint64_t n, double theta)
+        : n_(n), theta_(theta), zeta_n_(zeta(n, theta)), alpha_(1.0 / (1.0 - theta)) {
+        eta_ = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta(2, theta) / zeta_n_);
+    }
+
+    template <typename Rng>
+    std::uint64_t operator()(Rng& rng) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zeta_n_;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + std::pow(0.5, theta_)) return 1;
+        auto rank = static_cast<std::uint64_t>(static_cast<double>(n_) * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+        return std::min(rank, n_ - 1);
+    }
+
+private:
+    static double zeta(std::uint64_t n, double theta) {
+        double sum = 0;
+        for (std::uint64_t i = 1; i <= n; ++i) sum += 1.0 / std::pow(static_cast<double>(i), theta);
+        return sum;
+    }
+
+    std::uint64_t n_;
+    double theta_;
+    double zeta_n_;
+    double alpha_;
+    double eta_;
+};
+
+struct Op {
+    int key;
+    bool read;
+};
+
+// Operations are generated up front so the timed loop measures only the map.
+static std::vector<std::vector<Op>> make_ops(const Config& config, int threads,
+                                              const std::string& distribution, double read_ratio) {
+    std::vector<std::vector<Op>> ops(threads);
+    Zipf_Generator zipf(config.keys, config.zipf_theta);
+
+    for (int t = 0; t < threads; ++t) {
+        std::mt19937_64 rng(12345 + t);
+        std::uniform_int_distribution<int> uniform(0, static_cast<int>(config.keys) - 1);
+        std::bernoulli_distribution is_read(read_ratio);
+
+        ops[t].reserve(config.ops);
+        for (std::size_t i = 0; i < config.ops; ++i) {
+            int key = distribution == "zipf" ? static_cast<int>(zipf(rng)) : uniform(rng);
+            ops[t].push_back({key, is_read(rng)});
+        }
+    }
+    return ops;
+}
+
+// Runs body(t) on `threads` threads released together; returns wall time from
+// the first worker starting to the last one finishing, as the workers clock it.
+static double run_threads(int threads, const std::function<void(int)>& body) {
+    std::latch ready(threads + 1);
+    std::vector<std::thread> workers;
+    std::vector<Clock::time_point> starts(threads), ends(threads);
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            ready.arrive_and_wait();
+            starts[t] = Clock::now();
+            body(t);
+            ends[t] = Clock::now();
+        });
+    }
+
+    ready.arrive_and_wait();
+    for (auto& worker : workers) worker.join();
+    return std::chrono::duration<double>(*std::max_element(ends.begin(), ends.end()) -
+                                         *std::min_element(starts.begin(), starts.end())).count();
+}
+
+// Latency is timed on every 8th operation so the clock reads stay out of the
+// throughput number.
+template <typename Map, typename Get, typename Put>
+static Result run_map(const std::string& name, Map& map, const Config& config, int threads,
+                      const std::string& distribution, double read_ratio, Get get, Put put) {
+    auto ops = make_ops(config, threads, distribution, read_ratio);
+    std::vector<Latency_Histogram> histograms(threads);
+
+    Result result;
+    result.benchmark = name;
+    result.threads = threads;
+    result.distribution = distribution;
+    result.read_ratio = read_ratio;
+    result.ops = config.ops * threads;
+    result.seconds = run_threads(threads, [&](int t) {
+        auto& hist = histograms[t];
+        const auto& my_ops = ops[t];
+
+        for (std::size_t i = 0; i < my_ops.size(); ++i) {
+            const Op& op = my_ops[i];
+            bool timed = (i & 7) == 0;
+            std::int64_t t0 = timed ? now_ns() : 0;
+
+            if (op.read) {
+                get(map, op.key);
+            } else {
+                put(map, op.key);
+            }
+
+            if (timed) hist.record(now_ns() - t0);
+        }
+    });
+
+    for (auto& hist : histograms) result.latency.merge(hist);
+    return result;
+}
+
+static Result bench_lru(const Config& config, int threads, const std::string& distribution, double read_ratio) {
+    // Total capacity is half the key space, so misses and evictions happen.
+    Concurrent_LRU<int, int> cache(std::max<std::size_t>(1, config.keys / 32));
+    for (std::size_t k = 0; k < config.keys; ++k) cache.insert(static_cast<int>(k), static_cast<int>(k));
+
+    return run_map("Concurrent_LRU", cache, config, threads, distribution, read_ratio,
+                   [](auto& c, int key) { volatile bool hit = c.get(key).has_value(); (void)hit; },
+                   [](auto& c, int key) { c.insert(key, key); });
+}
+
+static Result bench_striped(const Config& config, int threads, const std::string& distribution, double read_ratio) {
+    Striped_UM<int> map;
+    for (std::size_t k = 0; k < config.keys; ++k) map.insert(static_cast<int>(k), static_cast<int>(k));
+
+    return run_map("Striped_UM", map, config, threads, distribution, read_ratio,
+                   [](auto& m, int key) { volatile bool hit = m.get(key).has_value(); (void)hit; },
+                   [](auto& m, int key) { m.insert(key, key); });
+}
+
+// Latency is enqueue -> task start.
+static Result bench_thread_pool(const Config& config, int threads) {
+    const std::size_t total = config.ops * threads;
+    std::vector<std::uint64_t> latencies(total);
+    std::atomic<std::size_t> done{0};
+
+    Result result;
+    result.benchmark = "Thread_Pool";
+    result.threads = threads;
+    result.ops = total;
+    {
+        Thread_Pool pool(threads);
+        auto start = Clock::now();
+
+        run_threads(threads, [&](int t) {
+            std::size_t base = static_cast<std::size_t>(t) * config.ops;
+            for (std::size_t i = 0; i < config.ops; ++i) {
+                std::int64_t enqueued = now_ns();
+                std::uint64_t* slot = &latencies[base + i];
+                pool.enqueue([slot, enqueued, &done]() {
+                    *slot = now_ns() - enqueued;
+                    done.fetch_add(1, std::memory_order_release);
+                });
+            }
+        });
+
+        while (done.load(std::memory_order_acquire) < total) std::this_thread::yield();
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    for (auto latency : latencies) result.latency.record(latency);
+    return result;
+}
+
+// Half the threads produce, half consume (at least one of each); latency is
+// push -> pop.
+template <typename Push, typename Pop>
+static Result run_queue(const std::string& name, const Config& config, int threads, Push push, Pop pop) {
+    int producers = std::max(1, threads / 2);
+    int consumers = std::max(1, threads - producers);
+    const std::size_t total = config.ops * producers;
+
+    std::atomic<std::size_t> consumed{0};
+    std::vector<Latency_Histogram> histograms(consumers);
+
+    Result result;
+    result.benchmark = name;
+    result.threads = threads;
+    result.ops = total;
+    result.seconds = run_threads(producers + consumers, [&](int t) {
+        if (t < producers) {
+            for (std::size_t i = 0; i < config.ops; ++i) push(now_ns());
+            return;
+        }
+
+        auto& hist = histograms[t - producers];
+        std::int64_t value;
+        while (consumed.load(std::memory_order_relaxed) < total) {
+            if (pop(value)) {
+                hist.record(now_ns() - value);
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+
+    for (auto& hist : histograms) result.latency.merge(hist);
+    return result;
+}
+
+static Result bench_blocking_queue(const Config& config, int threads) {
+    BlockingQueue<std::int64_t> queue(1024);
+    return run_queue("BlockingQueue", config, threads,
+                     [&](std::int64_t v) { queue.push(v); },
+                     [&](std::int64_t& v) {
+                         auto item = queue.pop_for(std::chrono::milliseconds(1));
+                         if (!item) return false;
+                         v = *item;
+                         return true;
+                     });
+}
+
+static Result bench_lock_free_queue(const Config& config, int threads) {
+    Lock_Free_Queue<std::int64_t> queue;
+    return run_queue("Lock_Free_Queue", config, threads,
+                     [&](std::int64_t v) { queue.push(v); },
+                     [&](std::int64_t& v) { return queue.pop(v); });
+}
+
+static void write_json(std::ostream& out, const Config& config, const std::vector<Result>& results) {
+    out << "{\n";
+    out << "  \"timestamp\": " << std::time(nullptr) << ",\n";
+    out << "  \"hardware_concurrency\": " << std::thread::hardware_concurrency() << ",\n";
+    out << "  \"ops_per_thread\": " << config.ops << ",\n";
+    out << "  \"keys\": " << config.keys << ",\n";
+    out << "  \"zipf_theta\": " << config.zipf_theta << ",\n";
+    out << "  \"results\": [\n";
+
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        const Latency_Histogram& h = r.latency;
+
+        out << "    {\"benchmark\": \"" << r.benchmark << "\", \"threads\": " << r.threads;
+        if (!r.distribution.empty()) {
+            out << ", \"distribution\": \"" << r.distribution << "\", \"read_ratio\": " << r.read_ratio;
+        }
+        out << ", \"ops\": " << r.ops
+            << ", \"seconds\": " << r.seconds
+            << ", \"ops_per_sec\": " << static_cast<std::uint64_t>(static_cast<double>(r.ops) / r.seconds)
+            << ", \"latency_ns\": {\"samples\": " << h.count()
+            << ", \"min\": " << h.min()
+            << ", \"mean\": " << static_cast<std::uint64_t>(h.mean())
+            << ", \"p50\": " << h.percentile(50)
+            << ", \"p90\": " << h.percentile(90)
+            << ", \"p99\": " << h.percentile(99)
+            << ", \"p999\": " << h.percentile(99.9)
+            << ", \"max\": " << h.max() << "}}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+
+    out << "  ]\n}\n";
+}
+
+template <typename T>
+static std::vector<T> parse_list(const std::string& value) {
+    std::vector<T> items;
+    std::stringstream stream(value);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        std::istringstream item_stream(item);
+        T parsed;
+        item_stream >> parsed;
+        items.push_back(parsed);
+    }
+    return items;
+}
+
+static void usage(const char* name) {
+    std::cerr << "Usage: " << name << " [options]\n"
+              << "  --bench LIST       Thread_Pool,BlockingQueue,Lock_Free_Queue,Concurrent_LRU,Striped_UM\n"
+              << "  --threads LIST     thread counts to sweep (default 1,2,4,8)\n"
+              << "  --dist LIST        key distributions: uniform,zipf\n"
+              << "  --read-ratio LIST  read fractions for the maps (default 0.5,0.9,0.99)\n"
+              << "  --ops N            operations per thread (default 200000)\n"
+              << "  --keys N           key space for the maps (default 100000)\n"
+              << "  --zipf-theta X     Zipf skew, 0 < X < 1 (default 0.99)\n"
+              << "  --out FILE         write JSON to FILE instead of stdout\n";
+}
+
+int main(int argc, char* argv[]) {
+    Config config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--help" || i + 1 >= argc) {
+            usage(argv[0]);
+            return arg == "--help" ? 0 : 2;
+        }
+
+        std::string value = argv[++i];
+        if (arg == "--bench") config.benchmarks = parse_list<std::string>(value);
+        else if (arg == "--threads") config.threads = parse_list<int>(value);
+        else if (arg == "--dist") config.distributions = parse_list<std::string>(value);
+        else if (arg == "--read-ratio") config.read_ratios = parse_list<double>(value);
+        else if (arg == "--ops") config.ops = std::stoul(value);
+        else if (arg == "--keys") config.keys = std::stoul(value);
+        else if (arg == "--zipf-theta") config.zipf_theta = std::stod(value);
+        else if (arg == "--out") config.out = value;
+        else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    // The generator divides by 1 - theta and is only defined below 1.
+    if (!(config.zipf_theta > 0 && config.zipf_theta < 1)) {
+        std::cerr << "--zipf-theta must be between 0 and 1 (exclusive)\n";
+        return 2;
+    }
+
+    auto selected = [&](const std::string& name) {
+        return std::find(config.benchmarks.begin(), config.benchmarks.end(), name) != config.benchmarks.end();
+    };
+
+    std::vector<Result> results;
+    auto report = [&](Result result) {
+        std::cerr << result.benchmark << " threads=" << result.threads;
+        if (!result.distribution.empty()) {
+            std::cerr << " dist=" << result.distribution << " reads=" << result.read_ratio;
+        }
+        std::cerr << " -> " << static_cast<std::uint64_t>(static_cast<double>(result.ops) / result.seconds)
+                  << " ops/s, p99 " << result.latency.percentile(99) << " ns\n";
+        results.push_back(std::move(result));
+    };
+
+    for (int threads : config.threads) {
+        if (selected("Thread_Pool")) report(bench_thread_pool(config, threads));
+        if (selected("BlockingQueue")) report(bench_blocking_queue(config, threads));
+        if (selected("Lock_Free_Queue")) report(bench_lock_free_queue(config, threads));
+
+        for (const auto& distribution : config.distributions) {
+            for (double read_ratio : config.read_ratios) {
+                if (selected("Concurrent_LRU")) report(bench_lru(config, threads, distribution, read_ratio));
+                if (selected("Striped_UM")) report(bench_striped(config, threads, distribution, read_ratio));
+            }
+        }
+    }
+
+    if (config.out.empty()) {
+        write_json(std::cout, config, results);
+    } else {
+        std::ofstream file(config.out);
+        write_json(file, config, results);
+    }
+}
@@ -0,0 +1,75 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "Log_Format.h"
+
+static int decode_file(const std::string& path, std::ostream& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Cannot open " << path << '\n';
+        return 1;
+    }
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < log_file_magic.size() ||
+        !std::equal(log_file_magic.begin(), log_file_magic.end(), data.begin())) {
+        std::cerr << path << ": not a binary log file\n";
+        return 1;
+    }
+
+    std::vector<Format_Def> defs;
+    std::string line;
+
+    Log_Entry_Reader reader(data.data() + log_file_magic.size(), data.size() - log_file_magic.size());
+    Log_Entry entry;
+
+    try {
+        while (reader.next(entry)) {
+            if (entry.tag == Entry_Tag::Format) {
+                if (entry.format_id >= defs.size()) defs.resize(entry.format_id + 1);
+                defs[entry.format_id] = entry.def;
+                continue;
+            }
+
+            if (entry.format_id >= defs.size() || defs[entry.format_id].format.empty()) {
+                std::cerr << path << ": record references unknown format " << entry.format_id << '\n';
+                return 1;
+            }
+
+            line.clear();
+            line.push_back('[');
+            append_timestamp(line, entry.header.timestamp_ns);
+            line.append("] ");
+            format_message(line, defs[entry.format_id], entry.payload, entry.header.payload_size);
+            line.push_back('\n');
+            out << line;
+        }
+    } catch (std::exception& e) {
+        // A crash can leave a partially written tail; keep what was decoded.
+        std::cerr << path << ": " << e.what() << " at offset "
+                  << reader.offset() + log_file_magic.size() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file.blog>...\n";
+        return 2;
+    }
+
+    int status = 0;
+    for (int i = 1; i < argc; ++i) {
+        status |= decode_file(argv[i], std::cout);
+    }
+    return status;
+}
@@ -0,0 +1,171 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Log_Format.h"
+#include <ctime>
+#include <cstdio>
+#include <charconv>
+#include <stdexcept>
+
+Format_Registry& Format_Registry::instance() {
+    // Never destroyed: a static Logger may still format records during exit.
+    static Format_Registry* registry = new Format_Registry;
+    return *registry;
+}
+
+std::uint32_t Format_Registry::add(std::string_view format, const Arg_Type* layout, std::size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    defs_.push_back({std::string(format), std::vector<Arg_Type>(layout, layout + count)});
+    return static_cast<std::uint32_t>(defs_.size() - 1);
+}
+
+const Format_Def& Format_Registry::get(std::uint32_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return defs_.at(id);
+}
+
+void append_format_entry(std::string& out, std::uint32_t id, const Format_Def& def) {
+    auto arg_count = static_cast<std::uint16_t>(def.layout.size());
+    auto format_len = static_cast<std::uint32_t>(def.format.size());
+
+    out.push_back(static_cast<char>(Entry_Tag::Format));
+    out.append(reinterpret_cast<const char*>(&id), sizeof(id));
+    out.append(reinterpret_cast<const char*>(&arg_count), sizeof(arg_count));
+    for (Arg_Type type : def.layout) {
+        out.push_back(static_cast<char>(type));
+    }
+    out.append(reinterpret_cast<const char*>(&format_len), sizeof(format_len));
+    out.append(def.format);
+}
+
+void append_timestamp(std::string& out, std::int64_t timestamp_ns) {
+    std::time_t seconds = timestamp_ns / 1'000'000'000;
+    auto micros = static_cast<long>((timestamp_ns % 1'000'000'000) / 1000);
+
+    std::tm tm{};
+    localtime_r(&seconds, &tm);
+
+    char buf[40];
+    std::size_t len = std::strftime(buf, sizeof(buf), "%F %T", &tm);
+    len += std::snprintf(buf + len, sizeof(buf) - len, ".%06ld", micros);
+    out.append(buf, len);
+}
+
+namespace {
+    template <typename T>
+    T read_value(const char*& in, const char* end) {
+        if (static_cast<std::size_t>(end - in) < sizeof(T)) {
+            throw std::runtime_error("Truncated log record");
+        }
+        T value;
+        std::memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+        return value;
+    }
+
+    template <typename T>
+    void append_number(std::string& out, T value) {
+        char buf[32];
+        auto [ptr, ec] = std::to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, ptr);
+    }
+
+    void append_arg(std::string& out, Arg_Type type, const char*& in, const char* end) {
+        switch (type) {
+            case Arg_Type::Bool:
+                out.append(read_value<char>(in, end) ? "true" : "false");
+                break;
+            case Arg_Type::Char:
+                out.push_back(read_value<char>(in, end));
+                break;
+            case Arg_Type::Int:
+                append_number(out, read_value<std::int64_t>(in, end));
+                break;
+            case Arg_Type::UInt:
+                append_number(out, read_value<std::uint64_t>(in, end));
+                break;
+            case Arg_Type::Double:
+                append_number(out, read_value<double>(in, end));
+                break;
+            case Arg_Type::String: {
+                auto len = read_value<std::uint32_t>(in, end);
+                if (static_cast<std::size_t>(end - in) < len) {
+                    throw std::runtime_error("Truncated log record");
+                }
+                out.append(in, len);
+                in += len;
+                break;
+            }
+            default:
+                throw std::runtime_error("Unknown argument type");
+        }
+    }
+}
+
+void format_message(std::string& out, const Format_Def& def, const char* payload, std::size_t size) {
+    const char* in = payload;
+    const char* end = payload + size;
+    std::size_t arg = 0;
+
+    const std::string& format = def.format;
+    for (std::size_t i = 0; i < format.size(); ++i) {
+        char c = format[i];
+        if ((c == '{' || c == '}') && i + 1 < format.size() && format[i + 1] == c) {
+            out.push_back(c);
+            ++i;
+        } else if (c == '{') {
+            std::size_t close = format.find('}', i);
+            if (close == std::string::npos || arg >= def.layout.size()) {
+                out.append(format, i, std::string::npos);
+                break;
+            }
+            append_arg(out, def.layout[arg++], in, end);
+            i = close;
+        } else {
+            out.push_back(c);
+        }
+    }
+}
+
+bool Log_Entry_Reader::next(Log_Entry& entry) {
+    if (pos_ >= size_) return false;
+
+    const char* in = data_ + pos_;
+    const char* end = data_ + size_;
+
+    // Zero tail of a preallocated file that was not trimmed before a crash.
+    if (*in == 0) return false;
+
+    entry.tag = static_cast<Entry_Tag>(read_value<std::uint8_t>(in, end));
+
+    if (entry.tag == Entry_Tag::Record) {
+        entry.header = read_value<Record_Header>(in, end);
+        if (static_cast<std::size_t>(end - in) < entry.header.payload_size) {
+            throw std::runtime_error("Truncated log record");
+        }
+        entry.format_id = entry.header.format_id;
+        entry.payload = in;
+        in += entry.header.payload_size;
+    } else if (entry.tag == Entry_Tag::Format) {
+        entry.format_id = read_value<std::uint32_t>(in, end);
+        auto arg_count = read_value<std::uint16_t>(in, end);
+
+        entry.def.layout.clear();
+        for (std::uint16_t i = 0; i < arg_count; ++i) {
+            entry.def.layout.push_back(static_cast<Arg_Type>(read_value<std::uint8_t>(in, end)));
+        }
+
+        auto format_len = read_value<std::uint32_t>(in, end);
+        if (static_cast<std::size_t>(end - in) < format_len) {
+            throw std::runtime_error("Truncated format entry");
+        }
+        entry.def.format.assign(in, format_len);
+        in += format_len;
+    } else {
+        throw std::runtime_error("Unknown log entry tag");
+    }
+
+    pos_ = in - data_;
+    return true;
+}
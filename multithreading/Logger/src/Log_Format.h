@@ -0,0 +1,173 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+enum class Arg_Type : std::uint8_t {
+    Bool = 1,
+    Char,
+    Int,
+    UInt,
+    Double,
+    String
+};
+
+template <typename T>
+constexpr Arg_Type arg_type_of() {
+    using U = std::remove_cvref_t<T>;
+
+    if constexpr (std::is_same_v<U, bool>) {
+        return Arg_Type::Bool;
+    } else if constexpr (std::is_same_v<U, char>) {
+        return Arg_Type::Char;
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        return Arg_Type::Int;
+    } else if constexpr (std::is_integral_v<U>) {
+        return Arg_Type::UInt;
+    } else if constexpr (std::is_floating_point_v<U>) {
+        return Arg_Type::Double;
+    } else if constexpr (std::is_convertible_v<const U&, std::string_view>) {
+        return Arg_Type::String;
+    } else {
+        static_assert(sizeof(U) == 0, "Unsupported log argument type");
+    }
+}
+
+// Bytes an argument occupies in a record; strings add their length on top.
+constexpr std::size_t fixed_size(Arg_Type type) {
+    switch (type) {
+        case Arg_Type::Bool:
+        case Arg_Type::Char:   return 1;
+        case Arg_Type::Int:
+        case Arg_Type::UInt:
+        case Arg_Type::Double: return 8;
+        case Arg_Type::String: return sizeof(std::uint32_t);
+    }
+    return 0;
+}
+
+template <typename... Args>
+struct Arg_Layout {
+    static constexpr std::array<Arg_Type, sizeof...(Args)> types{arg_type_of<Args>()...};
+    static constexpr std::size_t fixed_bytes = (fixed_size(arg_type_of<Args>()) + ... + 0);
+};
+
+constexpr std::size_t count_placeholders(std::string_view format) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < format.size(); ++i) {
+        if (format[i] == '{') {
+            if (i + 1 < format.size() && format[i + 1] == '{') { ++i; continue; }
+            ++count;
+        }
+    }
+    return count;
+}
+
+template <typename T>
+std::size_t dynamic_size(const T& value) {
+    if constexpr (arg_type_of<T>() == Arg_Type::String) {
+        return std::string_view(value).size();
+    } else {
+        return 0;
+    }
+}
+
+template <typename T>
+char* encode_arg(char* out, const T& value) {
+    constexpr Arg_Type type = arg_type_of<T>();
+
+    if constexpr (type == Arg_Type::Bool || type == Arg_Type::Char) {
+        *out = static_cast<char>(value);
+        return out + 1;
+    } else if constexpr (type == Arg_Type::Int) {
+        std::int64_t v = value;
+        std::memcpy(out, &v, sizeof(v));
+        return out + sizeof(v);
+    } else if constexpr (type == Arg_Type::UInt) {
+        std::uint64_t v = value;
+        std::memcpy(out, &v, sizeof(v));
+        return out + sizeof(v);
+    } else if constexpr (type == Arg_Type::Double) {
+        double v = value;
+        std::memcpy(out, &v, sizeof(v));
+        return out + sizeof(v);
+    } else {
+        std::string_view sv(value);
+        auto len = static_cast<std::uint32_t>(sv.size());
+        std::memcpy(out, &len, sizeof(len));
+        std::memcpy(out + sizeof(len), sv.data(), sv.size());
+        return out + sizeof(len) + sv.size();
+    }
+}
+
+struct Format_Def {
+    std::string format;
+    std::vector<Arg_Type> layout;
+};
+
+// Process-wide table of format strings, one entry per log call site.
+class Format_Registry {
+public:
+    static Format_Registry& instance();
+
+    std::uint32_t add(std::string_view format, const Arg_Type* layout, std::size_t count);
+    const Format_Def& get(std::uint32_t id) const;
+
+private:
+    mutable std::mutex mutex_;
+    std::deque<Format_Def> defs_;
+};
+
+// Binary log layout: magic, then a stream of entries. Every entry starts with
+// a tag byte; a Format entry always precedes the first Record that uses it.
+inline constexpr std::array<char, 4> log_file_magic{'B', 'L', 'O', 'G'};
+
+enum class Entry_Tag : std::uint8_t {
+    Format = 1,
+    Record = 2
+};
+
+struct Record_Header {
+    std::uint32_t format_id;
+    std::uint32_t payload_size;
+    std::int64_t timestamp_ns;
+};
+
+inline constexpr std::size_t record_entry_size = 1 + sizeof(Record_Header);
+
+void append_format_entry(std::string& out, std::uint32_t id, const Format_Def& def);
+void append_timestamp(std::string& out, std::int64_t timestamp_ns);
+void format_message(std::string& out, const Format_Def& def, const char* payload, std::size_t size);
+
+struct Log_Entry {
+    Entry_Tag tag;
+    std::uint32_t format_id;
+    Format_Def def;               // Format entries only
+    Record_Header header;         // Record entries only
+    const char* payload = nullptr;
+};
+
+// Walks entries in a byte range; throws on a malformed entry.
+class Log_Entry_Reader {
+public:
+    Log_Entry_Reader(const char* data, std::size_t size): data_(data), size_(size) {}
+
+    bool next(Log_Entry& entry);
+    std::size_t offset() const { return pos_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+};
@@ -0,0 +1,92 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "Logger.h"
+
+// Token bucket in GCRA form: one atomic "theoretical arrival time" instead of
+// a token count plus refill timestamp, so allow() is a single CAS.
+class Rate_Limiter {
+public:
+    Rate_Limiter(double per_second, double burst)
+        : interval_ns_(static_cast<std::int64_t>(1e9 / per_second))
+        , tolerance_ns_(static_cast<std::int64_t>(1e9 / per_second * (burst > 1 ? burst - 1 : 0))) {}
+
+    // On success, suppressed is set to the number of lines dropped since the
+    // previous allowed one.
+    bool allow(std::uint64_t& suppressed) {
+        std::int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+
+        std::int64_t tat = tat_.load(std::memory_order_relaxed);
+        for (;;) {
+            std::int64_t start = tat > now ? tat : now;
+            if (start - now > tolerance_ns_) {
+                suppressed_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            if (tat_.compare_exchange_weak(tat, start + interval_ns_, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    const std::int64_t interval_ns_;
+    const std::int64_t tolerance_ns_;
+    std::atomic<std::int64_t> tat_{0};
+    std::atomic<std::uint64_t> suppressed_{0};
+};
+
+// Lets through one line out of every n.
+class Log_Sampler {
+public:
+    explicit Log_Sampler(std::uint64_t n): n_(n > 0 ? n : 1) {}
+
+    bool allow(std::uint64_t& suppressed) {
+        std::uint64_t seen = counter_.fetch_add(1, std::memory_order_relaxed);
+        if (seen % n_ != 0) return false;
+
+        suppressed = seen == 0 ? 0 : n_ - 1;
+        return true;
+    }
+
+private:
+    const std::uint64_t n_;
+    std::atomic<std::uint64_t> counter_{0};
+};
+
+// Both macros keep one limiter per call site (shared by all threads); the first
+// call fixes its parameters. Dropped lines are reported as a summary record
+// right before the next line that gets through.
+#define LOG_RATE_LIMITED(logger, per_second, burst, fmt, ...)                           \
+    do {                                                                                \
+        static Rate_Limiter log_limiter_(per_second, burst);                            \
+        std::uint64_t log_suppressed_ = 0;                                              \
+        if (log_limiter_.allow(log_suppressed_)) {                                      \
+            if (log_suppressed_ > 0) {                                                  \
+                LOG(logger, "{} lines suppressed at {}:{}", log_suppressed_, __FILE__, __LINE__); \
+            }                                                                           \
+            LOG(logger, fmt, __VA_ARGS__);                                              \
+        }                                                                               \
+    } while (0)
+
+#define LOG_SAMPLED(logger, n, fmt, ...)                                                \
+    do {                                                                                \
+        static Log_Sampler log_sampler_(n);                                             \
+        std::uint64_t log_suppressed_ = 0;                                              \
+        if (log_sampler_.allow(log_suppressed_)) {                                      \
+            if (log_suppressed_ > 0) {                                                  \
+                LOG(logger, "{} lines suppressed at {}:{}", log_suppressed_, __FILE__, __LINE__); \
+            }                                                                           \
+            LOG(logger, fmt, __VA_ARGS__);                                              \
+        }                                                                               \
+    } while (0)
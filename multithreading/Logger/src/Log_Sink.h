@@ -0,0 +1,47 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+
+// Destination for formatted or binary log batches. All calls come from the
+// logger's writer thread.
+class Log_Sink {
+public:
+    virtual ~Log_Sink() = default;
+
+    // Called before each batch; returns true when the batch starts a new file,
+    // so binary logs can repeat their header and format table.
+    virtual bool begin_batch() = 0;
+    virtual void write(const char* data, std::size_t size) = 0;
+    virtual void flush() = 0;
+};
+
+class Stream_Sink : public Log_Sink {
+public:
+    explicit Stream_Sink(std::ostream& out): out_(out) {}
+
+    bool begin_batch() override {
+        bool first = first_;
+        first_ = false;
+        return first;
+    }
+
+    // One flush per batch keeps redirected output current without paying
+    // for it on every line.
+    void write(const char* data, std::size_t size) override {
+        out_.write(data, static_cast<std::streamsize>(size));
+        out_.flush();
+    }
+
+    void flush() override {
+        out_.flush();
+    }
+
+private:
+    std::ostream& out_;
+    bool first_ = true;
+};
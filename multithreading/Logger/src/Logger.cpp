@@ -0,0 +1,115 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Logger.h"
+#include <algorithm>
+
+Logger::Logger(Mode mode, std::ostream& out)
+    : Logger(mode, std::make_unique<Stream_Sink>(out)) {}
+
+Logger::Logger(Mode mode, std::unique_ptr<Log_Sink> sink)
+    : mode_(mode)
+    , sink_(std::move(sink))
+    , running_(false) {}
+
+void Logger::start() {
+    if (running_.exchange(true)) return;
+    writer_ = std::thread(&Logger::writer_loop, this);
+}
+
+void Logger::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    cv_.notify_one();
+
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+Logger::~Logger() {
+    stop();
+}
+
+void Logger::writer_loop() {
+    std::vector<char> batch;
+
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return !buffer_.empty() || !running_; });
+
+            if (buffer_.empty()) break;
+            batch.swap(buffer_);
+        }
+
+        write_batch(batch);
+        batch.clear();
+    }
+
+    sink_->flush();
+}
+
+void Logger::write_batch(const std::vector<char>& batch) {
+    // Every file a sink starts must be decodable on its own.
+    if (sink_->begin_batch()) {
+        std::fill(written_defs_.begin(), written_defs_.end(), false);
+        if (mode_ == Mode::Binary) {
+            sink_->write(log_file_magic.data(), log_file_magic.size());
+        }
+    }
+
+    if (mode_ == Mode::Text) {
+        write_text(batch);
+    } else {
+        write_binary(batch);
+    }
+}
+
+const Format_Def& Logger::format_def(std::uint32_t id) {
+    if (id >= defs_.size()) {
+        defs_.resize(id + 1, nullptr);
+        written_defs_.resize(id + 1, false);
+    }
+    if (!defs_[id]) {
+        defs_[id] = &Format_Registry::instance().get(id);
+    }
+    return *defs_[id];
+}
+
+void Logger::write_text(const std::vector<char>& batch) {
+    Log_Entry_Reader reader(batch.data(), batch.size());
+    Log_Entry entry;
+
+    out_buffer_.clear();
+    while (reader.next(entry)) {
+        out_buffer_.push_back('[');
+        append_timestamp(out_buffer_, entry.header.timestamp_ns);
+        out_buffer_.append("] ");
+        format_message(out_buffer_, format_def(entry.format_id), entry.payload, entry.header.payload_size);
+        out_buffer_.push_back('\n');
+    }
+
+    sink_->write(out_buffer_.data(), out_buffer_.size());
+}
+
+void Logger::write_binary(const std::vector<char>& batch) {
+    Log_Entry_Reader reader(batch.data(), batch.size());
+    Log_Entry entry;
+
+    // Definitions for ids first seen in this batch go out ahead of it.
+    out_buffer_.clear();
+    while (reader.next(entry)) {
+        const Format_Def& def = format_def(entry.format_id);
+        if (!written_defs_[entry.format_id]) {
+            written_defs_[entry.format_id] = true;
+            append_format_entry(out_buffer_, entry.format_id, def);
+        }
+    }
+
+    sink_->write(out_buffer_.data(), out_buffer_.size());
+    sink_->write(batch.data(), batch.size());
+}
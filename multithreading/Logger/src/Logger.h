@@ -0,0 +1,106 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <condition_variable>
+#include "Log_Format.h"
+#include "Log_Sink.h"
+
+// The call site only copies a format id and raw argument bytes;
+// formatting happens on the writer thread or in log_decoder.
+#define LOG(logger, fmt, ...)                                             \
+    do {                                                                  \
+        struct Log_Site {                                                 \
+            static constexpr std::string_view format() { return fmt; }    \
+        };                                                                \
+        (logger).log<Log_Site>(__VA_ARGS__);                              \
+    } while (0)
+
+class Logger {
+public:
+    enum class Mode {
+        Text,      // writer thread formats records into text lines
+        Binary     // records are written as-is for offline decoding
+    };
+
+    Logger(Mode mode, std::ostream& out);
+    Logger(Mode mode, std::unique_ptr<Log_Sink> sink);
+    ~Logger();
+
+    Logger(const Logger& other) = delete;
+    Logger(Logger&& other) = delete;
+    Logger& operator=(const Logger& other) = delete;
+    Logger& operator=(Logger&& other) = delete;
+
+    void start();
+    void stop();
+
+    template <typename Site, typename... Args>
+    void log(const Args&... args);
+
+private:
+    void writer_loop();
+    void write_batch(const std::vector<char>& batch);
+    void write_text(const std::vector<char>& batch);
+    void write_binary(const std::vector<char>& batch);
+    const Format_Def& format_def(std::uint32_t id);
+
+private:
+    Mode mode_;
+    std::unique_ptr<Log_Sink> sink_;
+
+    std::thread writer_;
+    std::atomic<bool> running_;
+
+    std::mutex mutex_;                  // protects buffer_
+    std::condition_variable cv_;
+    std::vector<char> buffer_;          // encoded records waiting for the writer
+
+    // writer thread only
+    std::vector<const Format_Def*> defs_;
+    std::vector<bool> written_defs_;
+    std::string out_buffer_;
+};
+
+template <typename Site, typename... Args>
+void Logger::log(const Args&... args) {
+    using Layout = Arg_Layout<Args...>;
+    static_assert(count_placeholders(Site::format()) == sizeof...(Args),
+                  "Placeholder count does not match argument count");
+
+    static const std::uint32_t format_id =
+        Format_Registry::instance().add(Site::format(), Layout::types.data(), Layout::types.size());
+
+    Record_Header header{};
+    header.format_id = format_id;
+    header.payload_size = static_cast<std::uint32_t>(Layout::fixed_bytes + (dynamic_size(args) + ... + 0));
+    header.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+
+    bool was_empty;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::size_t offset = buffer_.size();
+        was_empty = offset == 0;
+
+        buffer_.resize(offset + record_entry_size + header.payload_size);
+        char* out = buffer_.data() + offset;
+
+        *out++ = static_cast<char>(Entry_Tag::Record);
+        std::memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        ((out = encode_arg(out, args)), ...);
+    }
+
+    if (was_empty) cv_.notify_one();
+}
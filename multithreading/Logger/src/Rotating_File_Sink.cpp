@@ -0,0 +1,231 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Rotating_File_Sink.h"
+#include <cstdio>
+#include <cerrno>
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+
+namespace {
+    void preallocate(int fd, std::size_t size) {
+#ifdef __linux__
+        // Reserves real blocks, so running out of disk is an error here
+        // instead of a SIGBUS on a later store into the mapping.
+        if (posix_fallocate(fd, 0, static_cast<off_t>(size)) == 0) return;
+#endif
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            throw std::runtime_error(std::string("Failed to preallocate log file: ") + std::strerror(errno));
+        }
+    }
+
+    void sync_data(int fd) {
+#ifdef __APPLE__
+        fsync(fd);
+#else
+        fdatasync(fd);
+#endif
+    }
+
+    char* map_file(int fd, std::size_t size) {
+        void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (map == MAP_FAILED) {
+            throw std::runtime_error(std::string("Failed to map log file: ") + std::strerror(errno));
+        }
+        return static_cast<char*>(map);
+    }
+}
+
+Rotating_File_Sink::Rotating_File_Sink(File_Sink_Options options)
+    : options_(std::move(options)) {
+    if (options_.max_file_size == 0) {
+        throw std::invalid_argument("max_file_size must be positive");
+    }
+
+    active_ = create_file();
+    active_->opened = std::chrono::steady_clock::now();
+    active_fd_ = active_->fd;
+
+    sync_thread_ = std::thread(&Rotating_File_Sink::sync_loop, this);
+}
+
+Rotating_File_Sink::~Rotating_File_Sink() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_one();
+    sync_thread_.join();
+
+    if (active_) finalize(*active_);
+
+    if (spare_) {
+        munmap(spare_->map, spare_->capacity);
+        close(spare_->fd);
+        unlink(spare_->path.c_str());
+    }
+}
+
+std::unique_ptr<Rotating_File_Sink::Log_File> Rotating_File_Sink::create_file() {
+    std::uint64_t sequence;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sequence = next_sequence_++;
+    }
+
+    char suffix[16];
+    std::snprintf(suffix, sizeof(suffix), ".%06llu", static_cast<unsigned long long>(sequence));
+
+    auto file = std::make_unique<Log_File>();
+    file->path = options_.path + suffix;
+    file->fd = open(file->path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (file->fd < 0) {
+        throw std::runtime_error("Failed to open " + file->path + ": " + std::strerror(errno));
+    }
+
+    try {
+        file->capacity = options_.max_file_size;
+        preallocate(file->fd, file->capacity);
+        file->map = map_file(file->fd, file->capacity);
+    } catch (...) {
+        close(file->fd);
+        unlink(file->path.c_str());
+        throw;
+    }
+
+    return file;
+}
+
+void Rotating_File_Sink::grow(Log_File& file, std::size_t min_capacity) const {
+    std::size_t capacity = std::max(file.capacity * 2, min_capacity);
+
+    preallocate(file.fd, capacity);
+    char* map = map_file(file.fd, capacity);
+
+    munmap(file.map, file.capacity);
+    file.map = map;
+    file.capacity = capacity;
+}
+
+void Rotating_File_Sink::finalize(Log_File& file) const {
+    // Trim the preallocated tail so the file ends at the last record.
+    if (file.map) munmap(file.map, file.capacity);
+    if (ftruncate(file.fd, static_cast<off_t>(file.size)) != 0) {
+        std::cerr << "Failed to trim " << file.path << ": " << std::strerror(errno) << '\n';
+    }
+    sync_data(file.fd);
+    close(file.fd);
+}
+
+bool Rotating_File_Sink::begin_batch() {
+    bool size_due = active_->size >= options_.max_file_size;
+    bool age_due = options_.max_file_age.count() > 0 &&
+                   std::chrono::steady_clock::now() - active_->opened >= options_.max_file_age;
+
+    if (active_->size > 0 && (size_due || age_due)) {
+        rotate();
+    }
+
+    bool fresh = fresh_;
+    fresh_ = false;
+    return fresh;
+}
+
+void Rotating_File_Sink::rotate() {
+    std::unique_ptr<Log_File> next;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        next = std::move(spare_);
+    }
+
+    if (!next) {
+        try {
+            next = create_file();
+        } catch (std::exception& e) {
+            std::cerr << "Log rotation failed, keep writing " << active_->path << ": " << e.what() << '\n';
+            return;
+        }
+    }
+
+    next->opened = std::chrono::steady_clock::now();
+    active_fd_ = next->fd;
+    dirty_ = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.push_back(std::move(active_));
+    }
+    cv_.notify_one();
+
+    active_ = std::move(next);
+    fresh_ = true;
+}
+
+void Rotating_File_Sink::write(const char* data, std::size_t size) {
+    if (active_->size + size > active_->capacity) {
+        try {
+            grow(*active_, active_->size + size);
+        } catch (std::exception& e) {
+            std::cerr << "Dropping " << size << " log bytes: " << e.what() << '\n';
+            return;
+        }
+    }
+
+    std::memcpy(active_->map + active_->size, data, size);
+    active_->size += size;
+    dirty_.store(true, std::memory_order_relaxed);
+}
+
+void Rotating_File_Sink::flush() {
+    sync_data(active_->fd);
+}
+
+void Rotating_File_Sink::sync_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (;;) {
+        while (!retired_.empty()) {
+            std::unique_ptr<Log_File> file = std::move(retired_.front());
+            retired_.pop_front();
+
+            lock.unlock();
+            finalize(*file);
+            lock.lock();
+        }
+
+        if (stop_) break;
+
+        if (!spare_) {
+            lock.unlock();
+            std::unique_ptr<Log_File> file;
+            try {
+                file = create_file();
+            } catch (std::exception& e) {
+                std::cerr << "Failed to prepare next log file: " << e.what() << '\n';
+            }
+            lock.lock();
+            spare_ = std::move(file);
+        }
+
+        // The fd stays open until this thread finalizes it, so syncing a file
+        // that was rotated out in the meantime is still safe.
+        if (dirty_.exchange(false)) {
+            int fd = active_fd_.load();
+            lock.unlock();
+            sync_data(fd);
+            lock.lock();
+        }
+
+        auto ready = [this]() { return stop_ || !retired_.empty(); };
+        if (options_.sync_interval.count() > 0) {
+            cv_.wait_for(lock, options_.sync_interval, ready);
+        } else {
+            cv_.wait(lock, ready);
+        }
+    }
+}
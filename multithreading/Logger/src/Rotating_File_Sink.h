@@ -0,0 +1,74 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <condition_variable>
+#include "Log_Sink.h"
+
+struct File_Sink_Options {
+    std::string path;                                   // files are named <path>.000001, <path>.000002, ...
+    std::size_t max_file_size = 64 * 1024 * 1024;       // rotate once a file reaches this size
+    std::chrono::seconds max_file_age{0};               // rotate after this long, 0 disables
+    std::chrono::milliseconds sync_interval{1000};      // fdatasync period, 0 syncs only on rotation
+};
+
+// Writes through a shared mapping of a preallocated file, so a batch is a
+// memcpy instead of a write() call. fdatasync, closing rotated files and
+// preparing the next file all run on a background sync thread.
+class Rotating_File_Sink : public Log_Sink {
+public:
+    explicit Rotating_File_Sink(File_Sink_Options options);
+    ~Rotating_File_Sink() override;
+
+    Rotating_File_Sink(const Rotating_File_Sink& other) = delete;
+    Rotating_File_Sink(Rotating_File_Sink&& other) = delete;
+    Rotating_File_Sink& operator=(const Rotating_File_Sink& other) = delete;
+    Rotating_File_Sink& operator=(Rotating_File_Sink&& other) = delete;
+
+    bool begin_batch() override;
+    void write(const char* data, std::size_t size) override;
+    void flush() override;
+
+private:
+    struct Log_File {
+        int fd = -1;
+        std::string path;
+        char* map = nullptr;
+        std::size_t capacity = 0;       // preallocated and mapped bytes
+        std::size_t size = 0;           // bytes written
+        std::chrono::steady_clock::time_point opened;
+    };
+
+    std::unique_ptr<Log_File> create_file();
+    void grow(Log_File& file, std::size_t min_capacity) const;
+    void finalize(Log_File& file) const;
+    void rotate();
+    void sync_loop();
+
+private:
+    File_Sink_Options options_;
+    std::unique_ptr<Log_File> active_;      // writer thread only
+    bool fresh_ = true;
+
+    std::thread sync_thread_;
+    bool stop_ = false;
+
+    std::mutex mutex_;                      // protects everything below
+    std::condition_variable cv_;
+    std::deque<std::unique_ptr<Log_File>> retired_;
+    std::unique_ptr<Log_File> spare_;
+    std::uint64_t next_sequence_ = 1;
+
+    std::atomic<int> active_fd_{-1};
+    std::atomic<bool> dirty_{false};
+};
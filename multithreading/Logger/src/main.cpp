@@ -0,0 +1,81 @@
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <string>
+#include "Logger.h"
+#include "Log_Limiter.h"
+#include "Rotating_File_Sink.h"
+
+void run_producers(Logger& logger) {
+    std::vector<std::thread> threads;
+
+    for (int i = 1; i <= 5; ++i) {
+        threads.emplace_back([i, &logger]() {
+            for (int j = 1; j <= 5; ++j) {
+                LOG(logger, "Threads {}: msg: {}", i, j);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+int main() {
+    {
+        Logger logger(Logger::Mode::Text, std::cout);
+        logger.start();
+        run_producers(logger);
+        LOG(logger, "Text mode done, {} {}", std::string("pi ="), 3.14159);
+        logger.stop();
+    }
+
+    {
+        Logger logger(Logger::Mode::Text, std::cout);
+        logger.start();
+
+        std::vector<std::thread> threads;
+        for (int i = 1; i <= 4; ++i) {
+            threads.emplace_back([i, &logger]() {
+                for (int j = 1; j <= 2000; ++j) {
+                    LOG_RATE_LIMITED(logger, 20, 5, "Hot path thread {}: request {}", i, j);
+                    LOG_SAMPLED(logger, 2000, "Sampled thread {}: request {}", i, j);
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logger.stop();
+    }
+
+    {
+        std::ofstream file("logger_demo.blog", std::ios::binary);
+        Logger logger(Logger::Mode::Binary, file);
+        logger.start();
+        run_producers(logger);
+        LOG(logger, "Binary mode done, ok={}", true);
+        logger.stop();
+    }
+
+    {
+        File_Sink_Options options;
+        options.path = "logger_demo_rotating.blog";
+        options.max_file_size = 4 * 1024;
+        options.sync_interval = std::chrono::milliseconds(100);
+
+        Logger logger(Logger::Mode::Binary, std::make_unique<Rotating_File_Sink>(options));
+        logger.start();
+        for (int burst = 0; burst < 20; ++burst) {
+            run_producers(logger);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        logger.stop();
+    }
+
+    std::cout << "Binary log written to logger_demo.blog, decode with: log_decoder logger_demo.blog\n";
+    std::cout << "Rotated logs written to logger_demo_rotating.blog.*, decode with: log_decoder logger_demo_rotating.blog.*\n";
+}
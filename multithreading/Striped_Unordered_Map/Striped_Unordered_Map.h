@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <optional>
+#include <functional>
+#include <shared_mutex>
+#include <unordered_map>
+
+template <typename T>
+class Striped_UM {
+public:
+    std::optional<T> get(T key) {
+        auto& stripe = stripes_[get_striped(key)];
+        std::shared_lock<std::shared_mutex> lock(stripe.shm_);
+
+        if (stripe.data_.contains(key)) {
+            return stripe.data_[key];
+        }
+
+        return std::nullopt;
+    }
+
+    void insert(T key, T value) {
+        auto& stripe = stripes_[get_striped(key)];
+        std::unique_lock<std::shared_mutex> lock(stripe.shm_);
+        stripe.data_[key] = value;
+    }
+
+    void erase(T key) {
+        auto& stripe = stripes_[get_striped(key)];
+        std::unique_lock<std::shared_mutex> lock(stripe.shm_);
+        stripe.data_.erase(key);
+    }
+    
+private:
+    static const size_t N = 16;
+
+    struct Striped {
+        std::unordered_map<T, T> data_;
+        std::shared_mutex shm_;
+    };
+
+    std::array<Striped, N> stripes_;
+    
+    size_t get_striped(const T& key) {
+        return std::hash<T>{}(key) % N;
+    }
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <mutex>
+#include <queue>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+
+class Thread_Pool {
+public:
+    explicit Thread_Pool(const size_t count_threads): threads_(count_threads) {
+        for (auto& thread : threads_) {
+            thread = std::thread(&Thread_Pool::worker, this);
+        }
+    }
+
+    void enqueue(const std::function<void()>& task) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            tasks_.push(task);
+        }
+        cv_.notify_one();
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    ~Thread_Pool() {
+        stop();
+    }
+
+private:
+    void worker() {
+        while (true) {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this]{ return stop_ || !tasks_.empty(); });
+
+                if (stop_ && tasks_.empty()) {
+                    return;
+                }
+
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+
+            task();
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::queue<std::function<void()>> tasks_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> stop_{false};
+};
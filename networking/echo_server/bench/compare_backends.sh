@@ -0,0 +1,30 @@
+#!/usr/bin/env bash
+# Runs load_generator against both backends at 1k, 10k and 50k connections.
+# Usage: bench/compare_backends.sh <echo_server build dir> <load_generator build dir> [server threads] [client threads]
+#
+# 50k connections need a descriptor limit above 50k for both processes
+# (ulimit -n) and several local addresses, since one source address only
+# has ~28k ephemeral ports.
+set -euo pipefail
+
+build=${1:?echo_server build dir}
+client=${2:?load_generator build dir}
+server_threads=${3:-$(nproc)}
+client_threads=${4:-$(nproc)}
+port=9500
+
+for backend in asio uring; do
+    for connections in 1000 10000 50000; do
+        "$build/echo_server" --backend "$backend" --threads "$server_threads" --port "$port" > /dev/null &
+        server=$!
+        sleep 1
+
+        result=$("$client/load_generator" --protocol echo --port "$port" --connections "$connections" \
+            --threads "$client_threads" --local-addrs $(( connections / 20000 + 1 )) --warmup 2 --seconds 10 --json)
+        echo "{\"backend\": \"$backend\", \"result\": $result}"
+
+        kill "$server"
+        wait "$server" 2> /dev/null || true
+        port=$(( port + 1 ))
+    done
+done
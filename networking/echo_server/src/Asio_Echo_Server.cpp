@@ -0,0 +1,138 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Asio_Echo_Server.h"
+#include <array>
+#include <thread>
+#include <iostream>
+#include <string_view>
+#include "Log_Limiter.h"
+
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+
+// Pause before accepting again when out of descriptors or memory.
+static constexpr auto accept_backoff = std::chrono::milliseconds(50);
+
+namespace {
+    // Accept errors that last until something is freed; retrying them at once spins.
+    bool out_of_resources(const boost::system::error_code& ec) {
+        return ec == boost::system::errc::too_many_files_open ||
+               ec == boost::system::errc::too_many_files_open_in_system ||
+               ec == boost::system::errc::no_buffer_space ||
+               ec == boost::system::errc::not_enough_memory;
+    }
+
+    // One connection: a read -> write cycle over a buffer the session owns, so no
+    // allocation happens per echo. The session lives as long as a handler holds it.
+    class Session : public std::enable_shared_from_this<Session> {
+    public:
+        explicit Session(tcp::socket socket): socket_(std::move(socket)) {
+            ++client_count;
+        }
+
+        ~Session() {
+            --client_count;
+            LOG_RATE_LIMITED(logger, 100, 200, "Client disconnected. Total: {}", client_count.load());
+        }
+
+        void start() {
+            do_read();
+        }
+
+    private:
+        void do_read() {
+            socket_.async_read_some(boost::asio::buffer(data_),
+                [self = shared_from_this()](boost::system::error_code ec, std::size_t length) {
+                    if (!ec) self->do_write(length);
+                });
+        }
+
+        void do_write(std::size_t length) {
+            boost::asio::async_write(socket_, boost::asio::buffer(data_, length),
+                [self = shared_from_this()](boost::system::error_code ec, std::size_t length) {
+                    if (ec) return;
+                    LOG_SAMPLED(logger, 1000, "Echoed: {}", std::string_view(self->data_.data(), length));
+                    self->do_read();
+                });
+        }
+
+        tcp::socket socket_;
+        std::array<char, 1024> data_;
+    };
+}
+
+Asio_Echo_Server::Asio_Echo_Server(const Echo_Options& options)
+    : port_(options.port) {
+    for (std::size_t i = 0; i < options.threads; ++i) {
+        contexts_.push_back(std::make_unique<boost::asio::io_context>(1));
+    }
+
+    std::size_t acceptor_count = options.reuse_port ? options.threads : 1;
+    for (std::size_t i = 0; i < acceptor_count; ++i) {
+        acceptors_.push_back(make_acceptor(*contexts_[i], options.reuse_port));
+    }
+
+    std::cout << "Server has been connected on port " << port_ << " (asio, " << options.threads << " threads, "
+              << acceptor_count << (options.reuse_port ? " SO_REUSEPORT acceptors" : " acceptor") << ")\n";
+}
+
+void Asio_Echo_Server::run() {
+    for (std::size_t i = 0; i < acceptors_.size(); ++i) {
+        do_accept(*acceptors_[i], acceptors_.size() == 1 ? nullptr : contexts_[i].get());
+    }
+
+    // Contexts without an acceptor only get work once a socket is handed to
+    // them; the guard keeps them from returning out of run() before that.
+    std::vector<std::thread> threads;
+    for (auto& context : contexts_) {
+        threads.emplace_back([&context]() {
+            auto work = boost::asio::make_work_guard(*context);
+            context->run();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+std::unique_ptr<tcp::acceptor> Asio_Echo_Server::make_acceptor(boost::asio::io_context& io, bool reuse) const {
+    auto acceptor = std::make_unique<tcp::acceptor>(io);
+    tcp::endpoint endpoint(tcp::v4(), port_);
+
+    acceptor->open(endpoint.protocol());
+    acceptor->set_option(tcp::acceptor::reuse_address(true));
+    if (reuse) acceptor->set_option(reuse_port(true));
+    acceptor->bind(endpoint);
+    acceptor->listen(boost::asio::socket_base::max_listen_connections);
+    return acceptor;
+}
+
+// Null target: spread accepted sockets over all contexts round-robin. Each
+// session starts on its socket's context, not on the acceptor's thread.
+void Asio_Echo_Server::do_accept(tcp::acceptor& acceptor, boost::asio::io_context* target) {
+    boost::asio::io_context& io = target ? *target : *contexts_[next_context_++ % contexts_.size()];
+
+    acceptor.async_accept(io, [this, &acceptor, target](boost::system::error_code ec, tcp::socket socket) {
+        if (!ec) {
+            boost::system::error_code endpoint_ec;
+            auto client = socket.remote_endpoint(endpoint_ec);
+
+            auto executor = socket.get_executor();
+            auto session = std::make_shared<Session>(std::move(socket));
+            LOG_RATE_LIMITED(logger, 100, 200, "New client: {}:{} | Total: {}",
+                             client.address().to_string(), client.port(), client_count.load());
+            boost::asio::post(executor, [session]() { session->start(); });
+        } else {
+            LOG_RATE_LIMITED(logger, 10, 10, "Accept error: {}", ec.message());
+            if (out_of_resources(ec)) {
+                auto backoff = std::make_shared<boost::asio::steady_timer>(acceptor.get_executor(), accept_backoff);
+                backoff->async_wait([this, &acceptor, target, backoff](boost::system::error_code) {
+                    do_accept(acceptor, target);
+                });
+                return;
+            }
+        }
+        do_accept(acceptor, target);
+    });
+}
@@ -0,0 +1,32 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <boost/asio.hpp>
+#include "Echo_Server.h"
+
+using boost::asio::ip::tcp;
+
+// A fixed set of io_context threads, one per core. Each context is driven by
+// exactly one thread, so it is created with concurrency hint 1 (no locking).
+// With reuse_port every context gets its own SO_REUSEPORT acceptor and the
+// kernel spreads connections; otherwise one acceptor hands sockets out round-robin.
+class Asio_Echo_Server {
+public:
+    explicit Asio_Echo_Server(const Echo_Options& options);
+    void run();
+
+private:
+    std::unique_ptr<tcp::acceptor> make_acceptor(boost::asio::io_context& io, bool reuse) const;
+    void do_accept(tcp::acceptor& acceptor, boost::asio::io_context* target);
+
+private:
+    unsigned short port_;
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts_;
+    std::vector<std::unique_ptr<tcp::acceptor>> acceptors_;
+    std::size_t next_context_ = 0;       // only touched by the single acceptor's thread
+};
@@ -0,0 +1,19 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include "Logger.h"
+
+// Shared by both backends, defined in main.cpp.
+extern Logger logger;
+extern std::atomic<int> client_count;
+
+struct Echo_Options {
+    unsigned short port = 8080;
+    std::size_t threads = 1;
+    bool reuse_port = false;            // Asio backend only, io_uring always uses one listener per thread
+};
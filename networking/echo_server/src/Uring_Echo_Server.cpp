@@ -0,0 +1,605 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Uring_Echo_Server.h"
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "Log_Limiter.h"
+
+namespace {
+    int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+    }
+
+    int sys_io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+        return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+    }
+
+    std::system_error errno_error(const char* what) {
+        return std::system_error(errno, std::generic_category(), what);
+    }
+
+    // Ring indices are shared with the kernel: loads of what it writes are
+    // acquire, stores of what it reads are release.
+    unsigned load_acquire(unsigned* p) {
+        return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+    }
+
+    void store_release(unsigned* p, unsigned value) {
+        std::atomic_ref<unsigned>(*p).store(value, std::memory_order_release);
+    }
+
+    // The SQ/CQ rings mapped from the ring fd. Submission is batched: get_sqe()
+    // only fills entries, submit() publishes all of them at once. SQEs that find
+    // the SQ full even after a submit (the kernel took none, e.g. EBUSY) wait in
+    // a backlog and move into the SQ, in order, as it drains.
+    class Uring {
+    public:
+        explicit Uring(unsigned entries) {
+            // Fastest first: completions only run when this thread waits for them
+            // (DEFER_TASKRUN), the ring is enabled later by the thread that owns it.
+            const unsigned flag_sets[] = {
+                IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_R_DISABLED,
+                IORING_SETUP_COOP_TASKRUN,
+                0,
+            };
+
+            io_uring_params params{};
+            for (unsigned flags : flag_sets) {
+                params = {};
+                params.flags = flags | IORING_SETUP_CQSIZE;
+                params.cq_entries = entries * 4;
+                fd_ = sys_io_uring_setup(entries, &params);
+                if (fd_ >= 0 || errno != EINVAL) break;
+            }
+            if (fd_ < 0) throw errno_error("io_uring_setup");
+            disabled_ = params.flags & IORING_SETUP_R_DISABLED;
+
+            sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            if (params.features & IORING_FEAT_SINGLE_MMAP) sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+
+            sq_ptr_ = mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+            if (sq_ptr_ == MAP_FAILED) throw errno_error("mmap sq ring");
+            cq_ptr_ = sq_ptr_;
+            if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+                cq_ptr_ = mmap(nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+                if (cq_ptr_ == MAP_FAILED) throw errno_error("mmap cq ring");
+            }
+            sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+            void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED) throw errno_error("mmap sqes");
+            sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+            auto* sq = static_cast<char*>(sq_ptr_);
+            sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sq_entries_ = params.sq_entries;
+            auto* array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            for (unsigned i = 0; i < sq_entries_; ++i) array[i] = i;       // SQE i always sits in slot i
+
+            auto* cq = static_cast<char*>(cq_ptr_);
+            cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            sqe_tail_ = submitted_ = *sq_tail_;
+        }
+
+        ~Uring() {
+            if (sqes_) munmap(sqes_, sqes_size_);
+            if (cq_ptr_ && cq_ptr_ != sq_ptr_ && cq_ptr_ != MAP_FAILED) munmap(cq_ptr_, cq_size_);
+            if (sq_ptr_ && sq_ptr_ != MAP_FAILED) munmap(sq_ptr_, sq_size_);
+            if (fd_ >= 0) close(fd_);
+        }
+
+        Uring(const Uring&) = delete;
+        Uring& operator=(const Uring&) = delete;
+
+        int fd() const {
+            return fd_;
+        }
+
+        // Must be called from the thread that will submit (SINGLE_ISSUER).
+        void enable() {
+            if (disabled_ && sys_io_uring_register(fd_, IORING_REGISTER_ENABLE_RINGS, nullptr, 0) < 0) {
+                throw errno_error("io_uring enable");
+            }
+            disabled_ = false;
+        }
+
+        io_uring_sqe* get_sqe() {
+            if (backlog_.empty() && sq_full()) {
+                submit(0);          // SQ full: push what we have without waiting
+            }
+            if (!backlog_.empty() || sq_full()) return &backlog_.emplace_back();
+            io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+            std::memset(sqe, 0, sizeof(*sqe));
+            ++sqe_tail_;
+            return sqe;
+        }
+
+        // Publishes every SQE filled since the last call in one io_uring_enter.
+        int submit(unsigned wait_for) {
+            while (!backlog_.empty() && !sq_full()) {
+                sqes_[sqe_tail_ & sq_mask_] = backlog_.front();
+                backlog_.pop_front();
+                ++sqe_tail_;
+            }
+            store_release(sq_tail_, sqe_tail_);
+            unsigned pending = sqe_tail_ - submitted_;
+            unsigned flags = wait_for ? IORING_ENTER_GETEVENTS : 0;
+            int ret = sys_io_uring_enter(fd_, pending, wait_for, flags);
+            if (ret < 0) return -errno;
+            submitted_ += static_cast<unsigned>(ret);
+            return ret;
+        }
+
+        template <typename Handler>
+        unsigned for_each_cqe(Handler&& handler) {
+            unsigned head = *cq_head_;
+            unsigned tail = load_acquire(cq_tail_);
+            for (unsigned i = head; i != tail; ++i) {
+                handler(cqes_[i & cq_mask_]);
+            }
+            store_release(cq_head_, tail);
+            return tail - head;
+        }
+
+    private:
+        bool sq_full() {
+            return sqe_tail_ - load_acquire(sq_head_) >= sq_entries_;
+        }
+
+        int fd_ = -1;
+        bool disabled_ = false;
+        void* sq_ptr_ = nullptr;
+        void* cq_ptr_ = nullptr;
+        std::size_t sq_size_ = 0;
+        std::size_t cq_size_ = 0;
+        std::size_t sqes_size_ = 0;
+
+        unsigned* sq_head_ = nullptr;
+        unsigned* sq_tail_ = nullptr;
+        unsigned sq_mask_ = 0;
+        unsigned sq_entries_ = 0;
+        io_uring_sqe* sqes_ = nullptr;
+        unsigned sqe_tail_ = 0;          // filled by us, not yet published
+        unsigned submitted_ = 0;         // consumed by the kernel
+        std::deque<io_uring_sqe> backlog_;  // filled while the SQ was full
+
+        unsigned* cq_head_ = nullptr;
+        unsigned* cq_tail_ = nullptr;
+        unsigned cq_mask_ = 0;
+        io_uring_cqe* cqes_ = nullptr;
+    };
+
+    // Provided buffer ring (IORING_REGISTER_PBUF_RING): the kernel picks a
+    // buffer for each recv, we hand it back with recycle() once it was sent.
+    // The ring is addressed as a plain io_uring_buf array with the tail in
+    // bufs[0].resv: in C++ the header's flex-array member lands at offset 8.
+    class Buffer_Ring {
+    public:
+        Buffer_Ring(int ring_fd, unsigned count, unsigned size, std::uint16_t group)
+            : count_(count), size_(size), mask_(count - 1), group_(group), data_(new char[std::size_t(count) * size]) {
+            ring_bytes_ = count * sizeof(io_uring_buf);
+            void* ring = mmap(nullptr, ring_bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ring == MAP_FAILED) throw errno_error("mmap buffer ring");
+            ring_ = static_cast<io_uring_buf*>(ring);
+
+            io_uring_buf_reg reg{};
+            reg.ring_addr = reinterpret_cast<std::uint64_t>(ring_);
+            reg.ring_entries = count;
+            reg.bgid = group;
+            if (sys_io_uring_register(ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+                int error = errno;
+                munmap(ring_, ring_bytes_);
+                throw std::system_error(error, std::generic_category(), "register buffer ring");
+            }
+
+            for (unsigned bid = 0; bid < count; ++bid) recycle(static_cast<std::uint16_t>(bid));
+            commit();
+        }
+
+        ~Buffer_Ring() {
+            munmap(ring_, ring_bytes_);
+        }
+
+        Buffer_Ring(const Buffer_Ring&) = delete;
+        Buffer_Ring& operator=(const Buffer_Ring&) = delete;
+
+        char* buffer(std::uint16_t bid) const {
+            return data_.get() + std::size_t(bid) * size_;
+        }
+
+        std::uint16_t group() const {
+            return group_;
+        }
+
+        void recycle(std::uint16_t bid) {
+            io_uring_buf& slot = ring_[(tail_ + pending_) & mask_];
+            slot.addr = reinterpret_cast<std::uint64_t>(buffer(bid));
+            slot.len = size_;
+            slot.bid = bid;
+            ++pending_;
+        }
+
+        // Makes every recycled buffer visible to the kernel; false if there were none.
+        bool commit() {
+            if (pending_ == 0) return false;
+            tail_ += pending_;
+            pending_ = 0;
+            std::atomic_ref<std::uint16_t>(ring_[0].resv).store(tail_, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        unsigned count_;
+        unsigned size_;
+        unsigned mask_;
+        std::uint16_t group_;
+        std::unique_ptr<char[]> data_;
+        io_uring_buf* ring_ = nullptr;
+        std::size_t ring_bytes_ = 0;
+        std::uint16_t tail_ = 0;
+        std::uint16_t pending_ = 0;
+    };
+
+    enum class Op : std::uint8_t {
+        Accept = 1,
+        Recv,
+        Send,
+        Cancel,
+    };
+
+    // user_data: op | buffer id | fd
+    std::uint64_t pack(Op op, std::uint16_t bid, int fd) {
+        return (std::uint64_t(op) << 56) | (std::uint64_t(bid) << 32) | std::uint32_t(fd);
+    }
+
+    Op op_of(std::uint64_t data) { return static_cast<Op>(data >> 56); }
+    std::uint16_t bid_of(std::uint64_t data) { return static_cast<std::uint16_t>(data >> 32); }
+    int fd_of(std::uint64_t data) { return static_cast<int>(data & 0xffffffff); }
+
+    constexpr unsigned ring_entries = 4096;
+    constexpr unsigned buffer_count = 8192;       // power of two, at most 32768
+    constexpr unsigned buffer_size = 2048;
+    constexpr std::uint16_t no_buffer = 0xffff;
+    constexpr std::uint16_t buffer_group = 0;
+    // Received bytes a connection may have waiting to be echoed before its recv
+    // is stopped, so a client that sends without reading cannot take every
+    // buffer of the thread; receiving resumes once half of it is sent.
+    constexpr std::uint32_t max_queued_bytes = 64 * 1024;
+
+    int make_listener(unsigned short port) {
+        int fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) throw errno_error("socket");
+
+        int on = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "bind/listen");
+        }
+        return fd;
+    }
+
+    // One thread: its ring, its listener, the connections it accepted.
+    class Worker {
+    public:
+        explicit Worker(int listen_fd)
+            : ring_(ring_entries), buffers_(ring_.fd(), buffer_count, buffer_size, buffer_group),
+              listen_fd_(listen_fd), buffer_len_(buffer_count), buffer_offset_(buffer_count),
+              buffer_next_(buffer_count, no_buffer) {}
+
+        ~Worker() {
+            close(listen_fd_);
+        }
+
+        void run() {
+            ring_.enable();
+            arm_accept();
+
+            for (;;) {
+                int ret = ring_.submit(1);
+                if (ret < 0 && ret != -EINTR && ret != -EAGAIN && ret != -EBUSY) {
+                    throw std::system_error(-ret, std::generic_category(), "io_uring_enter");
+                }
+
+                ring_.for_each_cqe([this](const io_uring_cqe& cqe) { handle(cqe); });
+                if (buffers_.commit()) rearm_starved();
+            }
+        }
+
+    private:
+        struct Connection {
+            bool open = false;
+            bool receiving = false;          // a multishot recv is armed
+            bool sending = false;            // one send in flight, always for head
+            bool closing = false;            // peer is gone, close once nothing is in flight
+            bool paused = false;             // recv stopped (or being cancelled) until the queue drains
+            std::uint16_t head = no_buffer;  // received buffers waiting to be echoed
+            std::uint16_t tail = no_buffer;
+            std::uint32_t queued = 0;        // bytes of those buffers
+        };
+
+        Connection& connection(int fd) {
+            if (static_cast<std::size_t>(fd) >= connections_.size()) connections_.resize(fd + 1024);
+            return connections_[fd];
+        }
+
+        void arm_accept() {
+            io_uring_sqe* sqe = ring_.get_sqe();
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->fd = listen_fd_;
+            sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+            sqe->accept_flags = SOCK_CLOEXEC;
+            sqe->user_data = pack(Op::Accept, 0, listen_fd_);
+        }
+
+        void arm_recv(int fd) {
+            io_uring_sqe* sqe = ring_.get_sqe();
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = fd;
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = buffers_.group();
+            sqe->user_data = pack(Op::Recv, 0, fd);
+            connections_[fd].receiving = true;
+        }
+
+        // Ends the connection's multishot recv; its last CQE comes with ECANCELED.
+        void cancel_recv(int fd) {
+            io_uring_sqe* sqe = ring_.get_sqe();
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = pack(Op::Recv, 0, fd);
+            sqe->user_data = pack(Op::Cancel, 0, fd);
+        }
+
+        void send_head(int fd) {
+            Connection& c = connections_[fd];
+            std::uint16_t bid = c.head;
+
+            io_uring_sqe* sqe = ring_.get_sqe();
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<std::uint64_t>(buffers_.buffer(bid) + buffer_offset_[bid]);
+            sqe->len = buffer_len_[bid] - buffer_offset_[bid];
+            sqe->msg_flags = MSG_NOSIGNAL;
+            sqe->user_data = pack(Op::Send, bid, fd);
+            c.sending = true;
+        }
+
+        void handle(const io_uring_cqe& cqe) {
+            switch (op_of(cqe.user_data)) {
+                case Op::Accept: on_accept(cqe); break;
+                case Op::Recv: on_recv(cqe); break;
+                case Op::Send: on_send(cqe); break;
+                case Op::Cancel: break;                     // the recv's own CQE tells the outcome
+            }
+        }
+
+        void on_accept(const io_uring_cqe& cqe) {
+            if (cqe.res >= 0) {
+                Connection& c = connection(cqe.res);
+                c = Connection{};
+                c.open = true;
+                ++client_count;
+                LOG_RATE_LIMITED(logger, 100, 200, "New client: fd {} | Total: {}", cqe.res, client_count.load());
+                arm_recv(cqe.res);
+            } else {
+                LOG_RATE_LIMITED(logger, 10, 10, "Accept error: {}", std::strerror(-cqe.res));
+            }
+            if (!(cqe.flags & IORING_CQE_F_MORE)) arm_accept();
+        }
+
+        void on_recv(const io_uring_cqe& cqe) {
+            int fd = fd_of(cqe.user_data);
+            Connection& c = connections_[fd];
+            bool more = cqe.flags & IORING_CQE_F_MORE;
+            if (!more) c.receiving = false;
+
+            if (cqe.res > 0) {
+                auto bid = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                buffer_len_[bid] = static_cast<std::uint32_t>(cqe.res);
+                buffer_offset_[bid] = 0;
+                enqueue(c, bid);
+                if (!c.sending) send_head(fd);
+                if (c.queued > max_queued_bytes && !c.paused) {
+                    c.paused = true;
+                    if (more) cancel_recv(fd);
+                }
+                if (!more && !c.closing && !c.paused) arm_recv(fd);     // multishot ended early (e.g. CQ overflow)
+                return;
+            }
+
+            if (c.paused && !c.closing && (cqe.res == -ECANCELED || cqe.res == -ENOBUFS)) {
+                resume(fd);                                 // if the queue drained meanwhile
+                return;
+            }
+            if (cqe.res == -ENOBUFS) {
+                starved_.push_back(fd);                     // re-armed once buffers come back
+                return;
+            }
+
+            c.closing = true;                               // 0 = orderly shutdown, < 0 = error
+            maybe_close(fd);
+        }
+
+        void on_send(const io_uring_cqe& cqe) {
+            int fd = fd_of(cqe.user_data);
+            std::uint16_t bid = bid_of(cqe.user_data);
+            Connection& c = connections_[fd];
+            c.sending = false;
+
+            if (cqe.res < 0) {
+                drop_queue(c);
+                c.closing = true;
+                shutdown(fd, SHUT_RDWR);                    // terminates the armed recv
+                maybe_close(fd);
+                return;
+            }
+
+            buffer_offset_[bid] += static_cast<std::uint32_t>(cqe.res);
+            if (buffer_offset_[bid] < buffer_len_[bid]) {   // short send: rest of the same buffer
+                send_head(fd);
+                return;
+            }
+
+            LOG_SAMPLED(logger, 1000, "Echoed: {}", std::string_view(buffers_.buffer(bid), buffer_len_[bid]));
+            c.head = buffer_next_[bid];
+            if (c.head == no_buffer) c.tail = no_buffer;
+            c.queued -= buffer_len_[bid];
+            buffers_.recycle(bid);
+            resume(fd);
+
+            if (c.head != no_buffer) {
+                send_head(fd);
+            } else {
+                maybe_close(fd);
+            }
+        }
+
+        void enqueue(Connection& c, std::uint16_t bid) {
+            buffer_next_[bid] = no_buffer;
+            if (c.tail == no_buffer) {
+                c.head = bid;
+            } else {
+                buffer_next_[c.tail] = bid;
+            }
+            c.tail = bid;
+            c.queued += buffer_len_[bid];
+        }
+
+        void drop_queue(Connection& c) {
+            for (std::uint16_t bid = c.head; bid != no_buffer; bid = buffer_next_[bid]) {
+                buffers_.recycle(bid);
+            }
+            c.head = c.tail = no_buffer;
+            c.queued = 0;
+        }
+
+        // Receives again once a paused connection's recv has ended and half its queue is sent.
+        void resume(int fd) {
+            Connection& c = connections_[fd];
+            if (!c.paused || c.receiving || c.closing || c.queued > max_queued_bytes / 2) return;
+            c.paused = false;
+            arm_recv(fd);
+        }
+
+        // Data already received is still echoed after the peer half-closes.
+        void maybe_close(int fd) {
+            Connection& c = connections_[fd];
+            if (!c.open || !c.closing || c.receiving || c.sending || c.head != no_buffer) return;
+
+            c.open = false;
+            close(fd);
+            --client_count;
+            LOG_RATE_LIMITED(logger, 100, 200, "Client disconnected. Total: {}", client_count.load());
+        }
+
+        void rearm_starved() {
+            std::vector<int> starved;
+            starved.swap(starved_);
+            for (int fd : starved) {
+                Connection& c = connections_[fd];
+                if (c.open && !c.closing && !c.receiving && !c.paused) arm_recv(fd);
+            }
+        }
+
+    private:
+        Uring ring_;
+        Buffer_Ring buffers_;
+        int listen_fd_;
+        std::vector<Connection> connections_;           // indexed by fd
+        std::vector<std::uint32_t> buffer_len_;         // indexed by buffer id
+        std::vector<std::uint32_t> buffer_offset_;
+        std::vector<std::uint16_t> buffer_next_;
+        std::vector<int> starved_;                      // recv ended with ENOBUFS
+    };
+}
+
+Uring_Echo_Server::Uring_Echo_Server(const Echo_Options& options)
+    : options_(options) {
+    std::cout << "Server has been connected on port " << options_.port << " (io_uring, " << options_.threads
+              << " threads, " << options_.threads << " SO_REUSEPORT listeners)\n";
+}
+
+void Uring_Echo_Server::run() {
+    // Listeners and rings are set up here so errors surface before any thread starts.
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (std::size_t i = 0; i < options_.threads; ++i) {
+        workers.push_back(std::make_unique<Worker>(make_listener(options_.port)));
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker]() {
+            try {
+                worker->run();
+            } catch (std::exception& e) {
+                std::cout << "Worker error: " << e.what() << '\n';
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+bool Uring_Echo_Server::supported(std::string& reason) {
+    // Multishot recv and buffer rings landed in 6.0.
+    utsname name{};
+    int major = 0, minor = 0;
+    if (uname(&name) != 0 || std::sscanf(name.release, "%d.%d", &major, &minor) != 2) {
+        reason = "cannot read kernel version";
+        return false;
+    }
+    if (major < 6) {
+        reason = std::string("kernel ") + name.release + " < 6.0";
+        return false;
+    }
+
+    // Seccomp profiles (containers) often block io_uring entirely.
+    try {
+        Uring ring(8);
+        Buffer_Ring buffers(ring.fd(), 8, 64, buffer_group);
+    } catch (std::exception& e) {
+        reason = e.what();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,27 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <string>
+#include "Echo_Server.h"
+
+// io_uring backend, talking to the kernel through the raw syscalls (no liburing).
+// Every thread owns a ring and an SO_REUSEPORT listener, so threads share nothing:
+//   - one multishot accept per listener produces a CQE per new connection
+//   - one multishot recv per connection picks buffers from a provided buffer ring
+//   - the received buffer itself is sent back and then returned to the ring,
+//     so an echo never copies and the buffer pool is shared by all connections
+//   - all SQEs produced while handling a batch of CQEs go out in one io_uring_enter
+class Uring_Echo_Server {
+public:
+    explicit Uring_Echo_Server(const Echo_Options& options);
+    void run();
+
+    // False (with a reason) if the kernel lacks multishot accept/recv or buffer rings.
+    static bool supported(std::string& reason);
+
+private:
+    Echo_Options options_;
+};
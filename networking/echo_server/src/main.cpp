@@ -0,0 +1,64 @@
+#include <sys/resource.h>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <algorithm>
+#include "Echo_Server.h"
+#include "Asio_Echo_Server.h"
+#include "Uring_Echo_Server.h"
+
+std::atomic<int> client_count = 0;
+Logger logger(Logger::Mode::Text, std::cout);
+
+// Every connection is a descriptor; lift the soft limit to the hard one.
+static void raise_fd_limit() {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Echo_Options options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string backend = "asio";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max(1ul, std::stoul(argv[++i]));
+        } else if (arg == "--port" && i + 1 < argc) {
+            options.port = static_cast<unsigned short>(std::stoul(argv[++i]));
+        } else if (arg == "--reuseport") {
+            options.reuse_port = true;
+        } else if (arg == "--backend" && i + 1 < argc && (argv[i + 1] == std::string("asio") || argv[i + 1] == std::string("uring"))) {
+            backend = argv[++i];
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--threads N] [--port P] [--reuseport] [--backend asio|uring]\n";
+            return 2;
+        }
+    }
+
+    std::string reason;
+    if (backend == "uring" && !Uring_Echo_Server::supported(reason)) {
+        std::cout << "io_uring unavailable (" << reason << "), falling back to asio\n";
+        backend = "asio";
+    }
+
+    logger.start();
+    raise_fd_limit();
+
+    try {
+        if (backend == "uring") {
+            Uring_Echo_Server server(options);
+            server.run();
+        } else {
+            Asio_Echo_Server server(options);
+            server.run();
+        }
+    } catch (std::exception& e) {
+        std::cout << "Server error: " << e.what() << '\n';
+    }
+}
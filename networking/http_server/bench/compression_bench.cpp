@@ -0,0 +1,80 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <ctime>
+#include "Compression.h"
+
+struct Payload {
+    std::string name;
+    std::string data;
+};
+
+static std::vector<Payload> make_payloads() {
+    std::string items = "[";
+    for (int i = 0; i < 200; ++i) {
+        if (i > 0) items += ',';
+        items += R"({"id":)" + std::to_string(i) + R"(,"name":"item )" + std::to_string(i) +
+                 R"(","price":)" + std::to_string(100 + i * 7 % 900) + R"(,"tags":["sale","new"],"in_stock":true})";
+    }
+    items += "]";
+
+    std::string records = "[";
+    for (int i = 0; i < 20000; ++i) {
+        if (i > 0) records += ',';
+        records += R"({"user":)" + std::to_string(i * 7919 % 100000) + R"(,"event":")" +
+                   (i % 3 == 0 ? "click" : i % 3 == 1 ? "view" : "purchase") + R"(","ts":)" +
+                   std::to_string(1700000000 + i * 13) + "}";
+    }
+    records += "]";
+
+    std::string log;
+    for (int i = 0; i < 20000; ++i) {
+        log += "2026-10-19 07:33:" + std::to_string(10 + i % 50) + " GET /api/v1/resource" + std::to_string(i % 40) +
+               "/" + std::to_string(i * 31 % 10000) + " -> 200 OK " + std::to_string(i % 900) + "us\n";
+    }
+
+    return {{"items_json", items}, {"events_json", records}, {"access_log", log}};
+}
+
+static double cpu_seconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+static volatile std::size_t sink;
+
+int main(int argc, char* argv[]) {
+    double min_seconds = 0.5;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--seconds") min_seconds = std::stod(argv[i + 1]);
+    }
+
+    std::cout << std::left << std::setw(13) << "payload" << std::right << std::setw(10) << "bytes"
+              << std::setw(7) << "level" << std::setw(10) << "gzip" << std::setw(8) << "ratio"
+              << std::setw(10) << "MB/s" << std::setw(12) << "CPU ms/MB" << '\n';
+
+    for (const Payload& payload : make_payloads()) {
+        for (int level : {1, 6, 9}) {
+            std::size_t compressed = 0;
+            std::size_t iterations = 0;
+            double start = cpu_seconds();
+            double elapsed = 0;
+            do {
+                compressed = gzip(payload.data, level).size();
+                sink = sink + compressed;
+                ++iterations;
+                elapsed = cpu_seconds() - start;
+            } while (elapsed < min_seconds);
+
+            double mb = static_cast<double>(payload.data.size()) * static_cast<double>(iterations) / (1024 * 1024);
+            std::cout << std::fixed << std::setprecision(1)
+                      << std::left << std::setw(13) << payload.name << std::right << std::setw(10) << payload.data.size()
+                      << std::setw(7) << level << std::setw(10) << compressed
+                      << std::setw(7) << static_cast<double>(payload.data.size()) / static_cast<double>(compressed) << 'x'
+                      << std::setw(10) << mb / elapsed << std::setw(12) << std::setprecision(2) << elapsed * 1000 / mb << '\n';
+        }
+    }
+}
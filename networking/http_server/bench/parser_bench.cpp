@@ -0,0 +1,152 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <map>
+#include "Http_Parser.h"
+
+using Clock = std::chrono::steady_clock;
+
+// The parser http_server used before Http_Parser, kept verbatim as the baseline.
+struct Legacy_Request {
+    std::string method;
+    std::string path;
+    std::string version;
+    std::map<std::string, std::string> headers;
+    std::string body;
+
+    static Legacy_Request parse_request(const std::string& request) {
+        Legacy_Request req;
+        std::istringstream stream(request);
+        std::string line;
+
+        if (std::getline(stream, line)) {
+            std::istringstream line_stream(line);
+            line_stream >> req.method >> req.path >> req.version;
+        }
+
+        while (std::getline(stream, line) && line != "\r") {
+            auto colon_pos = line.find(':');
+            if (colon_pos != std::string::npos) {
+                std::string key = line.substr(0, colon_pos);
+                std::string value = line.substr(colon_pos + 1);
+
+                if (!value.empty() && value.back() == '\r') value.pop_back();
+                while (!value.empty() && value.front() == ' ') value.erase(value.begin());
+
+                req.headers[key] = value;
+            }
+        }
+
+        auto it = req.headers.find("Content-Length");
+        if (it != req.headers.end()) {
+            size_t len = std::stoul(it->second);
+            req.body.resize(len);
+            stream.read(req.body.data(), len);
+        }
+
+        return req;
+    }
+};
+
+struct Case {
+    std::string name;
+    std::string request;
+};
+
+static std::vector<Case> make_cases() {
+    std::string browser_headers =
+        "Host: localhost:8080\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:131.0) Gecko/20100101 Firefox/131.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+        "Connection: keep-alive\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "Sec-Fetch-Dest: document\r\n"
+        "Sec-Fetch-Mode: navigate\r\n"
+        "Sec-Fetch-Site: none\r\n"
+        "Priority: u=0, i\r\n";
+
+    std::string cookie = "Cookie: session=";
+    for (int i = 0; i < 40; ++i) cookie += "a1b2c3d4e5f6g7h8i9j0k1l2m3n4o5p6q7r8s9t0u1v2w3x4y5z6";
+    cookie += "\r\n";
+
+    std::string body(256, 'b');
+
+    return {
+        {"small_get", "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n"},
+        {"browser_get", "GET /json HTTP/1.1\r\n" + browser_headers + "\r\n"},
+        {"large_cookie", "GET /json HTTP/1.1\r\n" + browser_headers + cookie + "\r\n"},
+        {"post_body", "POST /submit HTTP/1.1\r\nHost: localhost\r\nContent-Type: text/plain\r\nContent-Length: " +
+                      std::to_string(body.size()) + "\r\n\r\n" + body},
+    };
+}
+
+static volatile std::size_t sink;
+
+// Runs batches until min_seconds passed; returns ns per call.
+template <typename F>
+static double measure(F&& parse_once, double min_seconds) {
+    std::size_t iterations = 0;
+    auto start = Clock::now();
+    double elapsed = 0;
+    do {
+        for (int i = 0; i < 1000; ++i) parse_once();
+        iterations += 1000;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < min_seconds);
+    return elapsed * 1e9 / static_cast<double>(iterations);
+}
+
+int main(int argc, char* argv[]) {
+    double min_seconds = 0.5;
+    std::size_t split = 64;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--seconds") min_seconds = std::stod(argv[i + 1]);
+        else if (arg == "--split") split = std::max(1ul, std::stoul(argv[i + 1]));
+    }
+
+    std::cout << std::left << std::setw(14) << "case" << std::right << std::setw(8) << "bytes"
+              << std::setw(14) << "legacy ns" << std::setw(14) << "new ns" << std::setw(14) << "split ns"
+              << std::setw(12) << "new MB/s" << std::setw(10) << "speedup" << '\n';
+
+    for (const Case& c : make_cases()) {
+        Http_Parser parser;
+        Http_Request request;
+        std::string_view data = c.request;
+
+        double legacy_ns = measure([&]() {
+            Legacy_Request r = Legacy_Request::parse_request(c.request);
+            sink = sink + r.headers.size() + r.body.size();
+        }, min_seconds);
+
+        double new_ns = measure([&]() {
+            parser.reset();
+            if (parser.parse(data, request) != Http_Parser::Status::Complete) std::abort();
+            sink = sink + request.header_count + request.body.size();
+        }, min_seconds);
+
+        // The same request arriving in split-byte reads: every read re-enters the parser.
+        double split_ns = measure([&]() {
+            parser.reset();
+            Http_Parser::Status status = Http_Parser::Status::Incomplete;
+            // Body: head done, the Content-Length body not all there yet.
+            for (std::size_t size = std::min(split, data.size()); status == Http_Parser::Status::Incomplete ||
+                 status == Http_Parser::Status::Body; size = std::min(size + split, data.size())) {
+                status = parser.parse(data.substr(0, size), request);
+            }
+            if (status != Http_Parser::Status::Complete) std::abort();
+            sink = sink + request.header_count;
+        }, min_seconds);
+
+        double mb_per_s = static_cast<double>(c.request.size()) / new_ns * 1e9 / (1024 * 1024);
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::left << std::setw(14) << c.name << std::right << std::setw(8) << c.request.size()
+                  << std::setw(14) << legacy_ns << std::setw(14) << new_ns << std::setw(14) << split_ns
+                  << std::setw(12) << mb_per_s << std::setw(9) << legacy_ns / new_ns << "x\n";
+    }
+}
@@ -0,0 +1,196 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "Http_Server.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Every global allocation of the process. The client below does not allocate
+// while measuring and the logger writes binary records into a reused buffer,
+// so what is counted comes from the server handling requests.
+static std::atomic<std::uint64_t> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    std::size_t alignment = static_cast<std::size_t>(align);
+    if (void* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+    struct Null_Buffer : std::streambuf {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+    Null_Buffer null_buffer;
+    std::ostream null_stream(&null_buffer);
+}
+
+Logger logger(Logger::Mode::Binary, null_stream);
+
+struct Case {
+    std::string name;
+    std::string request;
+};
+
+struct Result {
+    double requests_per_second;
+    double allocations_per_request;
+};
+
+// One keep-alive connection sending `pipeline` requests per write and reading
+// back as many responses (framed by Content-Length) before the next write.
+class Client {
+public:
+    explicit Client(unsigned short port) : buffer_(1 << 20) {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            throw std::runtime_error("connect failed");
+        }
+    }
+
+    ~Client() {
+        ::close(fd_);
+    }
+
+    // False if the connection broke or a response was not 200.
+    bool exchange(std::string_view requests, std::size_t count) {
+        for (std::size_t sent = 0; sent < requests.size();) {
+            ssize_t n = ::send(fd_, requests.data() + sent, requests.size() - sent, 0);
+            if (n <= 0) return false;
+            sent += static_cast<std::size_t>(n);
+        }
+        while (count > 0) {
+            std::string_view data(buffer_.data(), size_);
+            std::size_t head_end = data.find("\r\n\r\n");
+            if (head_end != std::string_view::npos) {
+                if (data.substr(9, 3) != "200") return false;
+                std::size_t length_at = data.substr(0, head_end).find("Content-Length: ");
+                std::size_t length = length_at == std::string_view::npos ? 0 : std::strtoul(data.data() + length_at + 16, nullptr, 10);
+                std::size_t total = head_end + 4 + length;
+                if (total <= size_) {
+                    std::memmove(buffer_.data(), buffer_.data() + total, size_ - total);
+                    size_ -= total;
+                    --count;
+                    continue;
+                }
+            }
+            ssize_t n = ::recv(fd_, buffer_.data() + size_, buffer_.size() - size_, 0);
+            if (n <= 0) return false;
+            size_ += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+private:
+    int fd_;
+    std::vector<char> buffer_;
+    std::size_t size_ = 0;
+};
+
+static Result run_case(unsigned short port, const Case& test, std::size_t pipeline, double seconds) {
+    std::string requests;
+    for (std::size_t i = 0; i < pipeline; ++i) requests += test.request;
+
+    Client client(port);
+    for (int i = 0; i < 200; ++i) {
+        if (!client.exchange(requests, pipeline)) throw std::runtime_error("request failed: " + test.name);
+    }
+
+    std::uint64_t before = allocations.load();
+    std::uint64_t count = 0;
+    auto start = Clock::now();
+    double elapsed = 0;
+    do {
+        for (int i = 0; i < 100; ++i) {
+            if (!client.exchange(requests, pipeline)) throw std::runtime_error("request failed: " + test.name);
+        }
+        count += 100 * pipeline;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < seconds);
+    std::uint64_t allocated = allocations.load() - before;
+
+    return {static_cast<double>(count) / elapsed, static_cast<double>(allocated) / static_cast<double>(count)};
+}
+
+int main(int argc, char* argv[]) {
+    double seconds = 1;
+    std::size_t pipeline = 16;
+    unsigned short port = 18080;
+    std::size_t arena_size = Http_Options().request_arena_size;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--seconds") seconds = std::stod(argv[i + 1]);
+        else if (arg == "--pipeline") pipeline = std::max(1ul, std::stoul(argv[i + 1]));
+        else if (arg == "--port") port = static_cast<unsigned short>(std::stoul(argv[i + 1]));
+        else if (arg == "--request-arena") arena_size = std::stoul(argv[i + 1]);
+    }
+
+    // A small page for the static file route.
+    std::string root = "/tmp/http_request_bench";
+    std::system(("mkdir -p " + root).c_str());
+    std::ofstream(root + "/index.html") << std::string(2048, 'x');
+
+    std::string body(600, 'b');
+    std::vector<Case> cases = {
+        {"hello", "GET /hello HTTP/1.1\r\nHost: localhost\r\n\r\n"},
+        {"users_id", "GET /users/42 HTTP/1.1\r\nHost: localhost\r\n\r\n"},
+        {"static_file", "GET /static/index.html HTTP/1.1\r\nHost: localhost\r\n\r\n"},
+        {"echo_600", "POST /echo HTTP/1.1\r\nHost: localhost\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body},
+    };
+
+    logger.start();
+    Http_Options options;
+    options.static_root = root;
+    options.max_requests_per_connection = std::numeric_limits<std::size_t>::max();
+    options.request_arena_size = arena_size;
+
+    Http_Server server(port, options);
+    std::thread server_thread([&server]() { server.run(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::cout << std::left << std::setw(14) << "route" << std::right << std::setw(14) << "req/s"
+              << std::setw(14) << "allocs/req" << '\n' << std::fixed;
+    for (const Case& test : cases) {
+        Result result = run_case(port, test, pipeline, seconds);
+        std::cout << std::left << std::setw(14) << test.name << std::right << std::setprecision(0)
+                  << std::setw(14) << result.requests_per_second << std::setprecision(3)
+                  << std::setw(14) << result.allocations_per_request << '\n';
+    }
+
+    server.stop();
+    server_thread.join();
+}
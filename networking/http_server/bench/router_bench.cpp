@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <chrono>
+#include <random>
+#include "Router.h"
+
+using Clock = std::chrono::steady_clock;
+
+// Baseline: what the if/else chain becomes once it has to handle parameters -
+// every route's pattern is compared segment by segment until one fits.
+struct Linear_Router {
+    struct Route {
+        Http_Method method;
+        std::vector<std::string> segments;
+        int id;
+    };
+
+    std::vector<Route> routes;
+
+    void add(Http_Method method, std::string_view pattern, int id) {
+        Route route{method, {}, id};
+        std::size_t pos = 1;
+        while (pos <= pattern.size()) {
+            std::size_t slash = std::min(pattern.find('/', pos), pattern.size());
+            route.segments.emplace_back(pattern.substr(pos, slash - pos));
+            pos = slash + 1;
+        }
+        routes.push_back(std::move(route));
+    }
+
+    int match(Http_Method method, std::string_view path, Route_Params& params) const {
+        for (const Route& route : routes) {
+            if (route.method != method) continue;
+            params.count = 0;
+            std::string_view rest = path.substr(1);
+            bool ok = true;
+            for (std::size_t i = 0; ok && i < route.segments.size(); ++i) {
+                std::size_t slash = rest.find('/');
+                std::string_view segment = rest.substr(0, slash);
+                rest = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
+                const std::string& pattern = route.segments[i];
+                if (pattern.front() == '{') {
+                    params.names[params.count] = std::string_view(pattern).substr(1, pattern.size() - 2);
+                    params.values[params.count++] = segment;
+                } else {
+                    ok = pattern == segment;
+                }
+                if (ok && slash == std::string_view::npos && i + 1 < route.segments.size()) ok = false;
+            }
+            if (ok && rest.empty()) return route.id;
+        }
+        return -1;
+    }
+};
+
+struct Lookup {
+    Http_Method method;
+    std::string path;
+};
+
+static volatile std::size_t sink;
+
+template <typename F>
+static double measure(const std::vector<Lookup>& lookups, F&& match_once, double min_seconds) {
+    std::size_t iterations = 0;
+    auto start = Clock::now();
+    double elapsed = 0;
+    do {
+        for (const Lookup& lookup : lookups) match_once(lookup);
+        iterations += lookups.size();
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < min_seconds);
+    return elapsed * 1e9 / static_cast<double>(iterations);
+}
+
+int main(int argc, char* argv[]) {
+    double min_seconds = 0.5;
+    std::size_t resources = 50;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--seconds") min_seconds = std::stod(argv[i + 1]);
+        else if (arg == "--resources") resources = std::max(1ul, std::stoul(argv[i + 1]));
+    }
+
+    // A REST-style API: 8 routes per resource, 5 of them with a parameter. The
+    // literal /search comes first so the linear scan agrees with the trie's precedence.
+    Router router;
+    Linear_Router linear;
+    std::vector<Lookup> hits;
+    int id = 0;
+    auto add = [&](Http_Method method, const std::string& pattern, const std::string& example) {
+        router.add(method, pattern, [id](const Http_Request&, const Route_Params&) { return Http_Response{200 + id, ""}; });
+        linear.add(method, pattern, id++);
+        hits.push_back({method, example});
+    };
+    for (std::size_t r = 0; r < resources; ++r) {
+        std::string base = "/api/v1/resource" + std::to_string(r);
+        add(Http_Method::Get, base, base);
+        add(Http_Method::Post, base, base);
+        add(Http_Method::Get, base + "/search", base + "/search");
+        add(Http_Method::Get, base + "/{id}", base + "/12345");
+        add(Http_Method::Put, base + "/{id}", base + "/12345");
+        add(Http_Method::Delete, base + "/{id}", base + "/12345");
+        add(Http_Method::Get, base + "/{id}/history", base + "/12345/history");
+        add(Http_Method::Get, base + "/{id}/owner", base + "/12345/owner");
+    }
+    router.compile();
+
+    std::vector<Lookup> misses;
+    for (std::size_t r = 0; r < resources; ++r) {
+        misses.push_back({Http_Method::Get, "/api/v1/resource" + std::to_string(r) + "/12345/unknown"});
+        misses.push_back({Http_Method::Get, "/api/v2/resource" + std::to_string(r)});
+    }
+
+    // Both routers must agree before their speed means anything.
+    for (const auto* set : {&hits, &misses}) {
+        for (const Lookup& lookup : *set) {
+            Route_Params params;
+            Route_Match match = router.match(lookup.method, lookup.path);
+            int expected = linear.match(lookup.method, lookup.path, params);
+            int got = match.handler ? (*match.handler)({}, match.params).status - 200 : -1;
+            if (got != expected || (got >= 0 && match.params.get("id") != params.get("id"))) {
+                std::cerr << "mismatch on " << lookup.path << ": " << got << " vs " << expected << '\n';
+                return 1;
+            }
+        }
+    }
+
+    std::mt19937 rng(42);
+    std::shuffle(hits.begin(), hits.end(), rng);
+
+    std::cout << router.route_count() << " routes\n"
+              << std::left << std::setw(10) << "lookups" << std::right << std::setw(14) << "linear ns"
+              << std::setw(14) << "trie ns" << std::setw(10) << "speedup" << '\n';
+
+    for (auto [name, set] : {std::pair{"hits", &hits}, std::pair{"misses", &misses}}) {
+        double linear_ns = measure(*set, [&](const Lookup& lookup) {
+            Route_Params params;
+            sink = sink + static_cast<std::size_t>(linear.match(lookup.method, lookup.path, params) + 1);
+        }, min_seconds);
+
+        double trie_ns = measure(*set, [&](const Lookup& lookup) {
+            Route_Match match = router.match(lookup.method, lookup.path);
+            sink = sink + (match.handler != nullptr) + match.params.count;
+        }, min_seconds);
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::left << std::setw(10) << name << std::right << std::setw(14) << linear_ns
+                  << std::setw(14) << trie_ns << std::setw(9) << linear_ns / trie_ns << "x\n";
+    }
+}
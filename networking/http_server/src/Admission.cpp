@@ -0,0 +1,65 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Admission.h"
+
+// A queue time older than this says nothing about the load now: the thread
+// has not read a request since, so it is idle, not overloaded.
+static constexpr auto queue_time_validity = std::chrono::milliseconds(100);
+
+Admission::Admission(boost::asio::io_context& io, const Admission_Options& options, std::size_t threads)
+    : options_(options),
+      max_connections_(options.max_connections == 0 ? 0 : std::max<std::size_t>(1, (options.max_connections + threads - 1) / threads)),
+      slot_timer_(io) {}
+
+bool Admission::overloaded() const {
+    return options_.max_queue_time.count() != 0 && queue_time_ > options_.max_queue_time &&
+           Clock::now() - measured_at_ < queue_time_validity;
+}
+
+bool Admission::connections_full() const {
+    return max_connections_ != 0 && connections_ >= max_connections_;
+}
+
+bool Admission::open_connection() {
+    if (connections_full() || overloaded()) {
+        ++rejected_connections_;
+        return false;
+    }
+    ++connections_;
+    return true;
+}
+
+void Admission::close_connection() {
+    --connections_;
+    if (waiting_for_slot_) slot_timer_.cancel();
+}
+
+boost::asio::awaitable<void> Admission::wait_for_slot() {
+    while (connections_full()) {
+        waiting_for_slot_ = true;
+        slot_timer_.expires_at(Clock::time_point::max());
+        boost::system::error_code ec;
+        co_await slot_timer_.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        waiting_for_slot_ = false;
+    }
+}
+
+bool Admission::begin_request(std::chrono::nanoseconds queued) {
+    if (options_.max_queue_time.count() != 0) {
+        queue_time_ = queued;
+        measured_at_ = Clock::now();
+    }
+    if ((options_.max_in_flight != 0 && in_flight_ >= options_.max_in_flight) ||
+        (options_.max_queue_time.count() != 0 && queued > options_.max_queue_time)) {
+        ++shed_requests_;
+        return false;
+    }
+    ++in_flight_;
+    return true;
+}
+
+void Admission::end_requests(std::size_t count) {
+    in_flight_ -= count;
+}
@@ -0,0 +1,75 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <boost/asio.hpp>
+
+struct Admission_Options {
+    std::size_t max_connections = 10000;            // open connections over all threads, 0: no limit
+    bool pause_accept = false;                      // at the limit stop accepting instead of answering 503
+    std::size_t max_in_flight = 0;                  // requests per thread parsed and not yet sent, 0: no limit
+    std::chrono::milliseconds max_queue_time{0};    // older requests are answered 503, 0: not measured
+    std::chrono::seconds retry_after{1};            // Retry-After of the 503 responses
+};
+
+// Admission state of one server thread, used only from its io_context, so
+// nothing here is atomic. Connections never leave the thread that accepted
+// them and SO_REUSEPORT spreads them evenly, so the connection limit is split
+// evenly over the threads.
+//
+// Queueing time is measured per read by the caller: how long ago the kernel
+// received the bytes (SO_TIMESTAMPNS), which covers the socket buffer and the
+// handlers queued ahead of the read. The latest one also decides whether new
+// connections are let in.
+class Admission {
+public:
+    Admission(boost::asio::io_context& io, const Admission_Options& options, std::size_t threads);
+
+    // A new connection: false if it is over the limit or requests are
+    // currently being shed; otherwise counted until close_connection().
+    bool open_connection();
+    void close_connection();
+
+    // Pause mode: completes once a connection slot is free, the kernel backlog queues the rest.
+    boost::asio::awaitable<void> wait_for_slot();
+
+    // A parsed request whose bytes waited `queued`: false if it should be
+    // answered 503; otherwise counted as in flight until end_requests()
+    // after its response is sent.
+    bool begin_request(std::chrono::nanoseconds queued);
+    void end_requests(std::size_t count);
+
+    bool overloaded() const;
+    bool connections_full() const;
+
+    std::chrono::nanoseconds queue_time() const {
+        return queue_time_;
+    }
+
+    std::uint64_t rejected_connections() const {
+        return rejected_connections_;
+    }
+
+    std::uint64_t shed_requests() const {
+        return shed_requests_;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Admission_Options options_;
+    std::size_t max_connections_;                   // this thread's share, 0: no limit
+    boost::asio::steady_timer slot_timer_;          // cancelled when a connection closes in pause mode
+    bool waiting_for_slot_ = false;
+
+    std::size_t connections_ = 0;
+    std::size_t in_flight_ = 0;
+    std::chrono::nanoseconds queue_time_{0};        // of the latest request
+    Clock::time_point measured_at_;
+    std::uint64_t rejected_connections_ = 0;
+    std::uint64_t shed_requests_ = 0;
+};
@@ -0,0 +1,106 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Compression.h"
+#include <algorithm>
+#include <stdexcept>
+#include "Http_Parser.h"
+
+namespace {
+    // Output grows by at most this much per deflate call (less for small inputs).
+    constexpr std::size_t output_chunk = 64 * 1024;
+
+    // deflateInit2 windowBits: 15 (32 KB window) + 16 for a gzip header and trailer.
+    constexpr int gzip_window_bits = 15 + 16;
+
+    std::string_view trim(std::string_view value) {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+        return value;
+    }
+
+    // "q=0", "q=0.0", "q=0.000" refuse the coding; any other q-value accepts it.
+    bool refused(std::string_view parameters) {
+        while (!parameters.empty()) {
+            std::size_t semicolon = parameters.find(';');
+            std::string_view parameter = trim(parameters.substr(0, semicolon));
+            parameters = semicolon == std::string_view::npos ? std::string_view() : parameters.substr(semicolon + 1);
+
+            if (parameter.size() < 2 || (parameter[0] != 'q' && parameter[0] != 'Q') || parameter[1] != '=') continue;
+            std::string_view q = parameter.substr(2);
+            return !q.empty() && q.find_first_not_of("0.") == std::string_view::npos;
+        }
+        return false;
+    }
+}
+
+bool accepts_gzip(std::string_view accept_encoding) {
+    bool wildcard = false;
+    while (!accept_encoding.empty()) {
+        std::size_t comma = accept_encoding.find(',');
+        std::string_view item = accept_encoding.substr(0, comma);
+        accept_encoding = comma == std::string_view::npos ? std::string_view() : accept_encoding.substr(comma + 1);
+
+        std::size_t semicolon = item.find(';');
+        std::string_view coding = trim(item.substr(0, semicolon));
+        std::string_view parameters = semicolon == std::string_view::npos ? std::string_view() : item.substr(semicolon + 1);
+
+        if (iequals(coding, "gzip")) return !refused(parameters);
+        if (coding == "*") wildcard = !refused(parameters);
+    }
+    return wildcard;
+}
+
+bool compressible(std::string_view content_type) {
+    std::string_view type = content_type.substr(0, content_type.find(';'));
+    return type.starts_with("text/") || type == "application/json" || type == "application/javascript" ||
+           type == "application/xml" || type == "image/svg+xml" || type == "application/wasm";
+}
+
+Gzip_Encoder::Gzip_Encoder(int level) {
+    if (deflateInit2(&stream_, level, Z_DEFLATED, gzip_window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("deflateInit2 failed");
+    }
+}
+
+Gzip_Encoder::~Gzip_Encoder() {
+    deflateEnd(&stream_);
+}
+
+void Gzip_Encoder::write(std::string_view input, std::string& out) {
+    deflate_into(input, Z_NO_FLUSH, out);
+}
+
+void Gzip_Encoder::finish(std::string& out) {
+    deflate_into({}, Z_FINISH, out);
+}
+
+void Gzip_Encoder::deflate_into(std::string_view input, int flush, std::string& out) {
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream_.avail_in = static_cast<uInt>(input.size());
+
+    for (;;) {
+        std::size_t used = out.size();
+        std::size_t chunk = std::min<std::size_t>(output_chunk, deflateBound(&stream_, stream_.avail_in) + 64);
+        out.resize(used + chunk);
+        stream_.next_out = reinterpret_cast<Bytef*>(out.data() + used);
+        stream_.avail_out = static_cast<uInt>(chunk);
+
+        int result = deflate(&stream_, flush);
+        out.resize(out.size() - stream_.avail_out);
+        if (result == Z_STREAM_ERROR) throw std::runtime_error("deflate failed");
+
+        // More output pending only if deflate used all the space it was given.
+        if (stream_.avail_out != 0 && (flush != Z_FINISH || result == Z_STREAM_END)) break;
+    }
+}
+
+std::string gzip(std::string_view input, int level) {
+    std::string out;
+    out.reserve(input.size() / 4 + 64);
+    Gzip_Encoder encoder(level);
+    encoder.write(input, out);
+    encoder.finish(out);
+    return out;
+}
@@ -0,0 +1,43 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <zlib.h>
+
+struct Compression_Options {
+    int level = 6;                                  // zlib level, 0 disables compression
+    std::size_t min_size = 1024;                    // smaller bodies are not worth a gzip header and a deflate call
+    std::size_t max_file_size = 64 * 1024 * 1024;   // larger static files are always sent as they are
+};
+
+// gzip if Accept-Encoding lists it (or *) with a non-zero q-value.
+bool accepts_gzip(std::string_view accept_encoding);
+
+// Text-like types; images, fonts and archives are already compressed.
+bool compressible(std::string_view content_type);
+
+// Streaming gzip: input is fed in any number of pieces, output is appended
+// to a string a chunk at a time, so a large body never needs one output
+// buffer sized for the worst case, nor its whole input in memory at once.
+class Gzip_Encoder {
+public:
+    explicit Gzip_Encoder(int level);
+    ~Gzip_Encoder();
+    Gzip_Encoder(const Gzip_Encoder&) = delete;
+    Gzip_Encoder& operator=(const Gzip_Encoder&) = delete;
+
+    void write(std::string_view input, std::string& out);
+    void finish(std::string& out);
+
+private:
+    void deflate_into(std::string_view input, int flush, std::string& out);
+
+    z_stream stream_{};
+};
+
+std::string gzip(std::string_view input, int level);
@@ -0,0 +1,297 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Http_Parser.h"
+#include <algorithm>
+#include <bit>
+#include <charconv>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+    char ascii_lower(char c) {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+    }
+
+    std::string_view trim(std::string_view s) {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+        return s;
+    }
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i] != b[i] && ascii_lower(a[i]) != ascii_lower(b[i])) return false;
+    }
+    return true;
+}
+
+std::string_view Http_Request::header(std::string_view name) const {
+    for (std::size_t i = 0; i < header_count; ++i) {
+        if (iequals(headers[i].name, name)) return headers[i].value;
+    }
+    return {};
+}
+
+// 16 bytes per step: compare against '\n', turn the result into a bit mask and
+// take the lowest set bit. The scalar loop handles the tail.
+const char* find_line_end(const char* p, const char* end) {
+#if defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; end - p >= 16; p += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline)));
+        if (mask) return p + std::countr_zero(mask);
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t newline = vdupq_n_u8('\n');
+    for (; end - p >= 16; p += 16) {
+        uint8x16_t eq = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p)), newline);
+        // Narrowing shift packs the 16 byte results into 4 bits each of one 64-bit lane.
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (mask) return p + (std::countr_zero(mask) >> 2);
+    }
+#endif
+    for (; p < end; ++p) {
+        if (*p == '\n') return p;
+    }
+    return end;
+}
+
+Http_Parser::Status Http_Parser::parse(std::string_view data, Http_Request& request) {
+    while (state_ != State::Body) {
+        const char* line_end = find_line_end(data.data() + scanned_, data.data() + data.size());
+        if (line_end == data.data() + data.size()) {
+            scanned_ = data.size();
+            if (scanned_ > max_head_size) return fail(431);
+            return Status::Incomplete;
+        }
+
+        std::size_t line_end_offset = static_cast<std::size_t>(line_end - data.data());
+        if (line_end_offset >= max_head_size) return fail(431);
+
+        std::string_view line = data.substr(line_begin_, line_end_offset - line_begin_);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        std::size_t line_begin = line_begin_;
+        line_begin_ = scanned_ = line_end_offset + 1;
+
+        if (state_ == State::Request_Line) {
+            if (line.empty()) continue;                     // stray CRLF between requests
+            if (!parse_request_line(line, line_begin)) return Status::Error;
+            state_ = State::Headers;
+        } else if (line.empty()) {
+            // Both framings at once is how requests get smuggled past proxies (RFC 9112 6.1).
+            if (chunked_ && has_content_length_) return fail(400);
+            body_begin_ = line_begin_;
+            state_ = State::Body;
+        } else if (!parse_header_line(line, line_begin)) {
+            return Status::Error;
+        }
+    }
+
+    fill(data, request);
+    if (chunked_ || content_length_ > max_body_size || data.size() < body_begin_ + content_length_) return Status::Body;
+    request.body = data.substr(body_begin_, content_length_);
+    return Status::Complete;
+}
+
+void Http_Parser::fill(std::string_view data, Http_Request& request) const {
+    auto view = [data](Span span) { return data.substr(span.begin, span.size); };
+    request.method = view(method_);
+    request.path = view(path_);
+    request.version = view(version_);
+    request.header_count = header_count_;
+    for (std::size_t i = 0; i < header_count_; ++i) {
+        request.headers[i] = {view(headers_[i].name), view(headers_[i].value)};
+    }
+    request.body = {};
+}
+
+bool Http_Parser::parse_request_line(std::string_view line, std::size_t line_begin) {
+    std::size_t first_space = line.find(' ');
+    std::size_t second_space = first_space == std::string_view::npos ? first_space : line.find(' ', first_space + 1);
+    if (first_space == 0 || second_space == std::string_view::npos || second_space == first_space + 1) {
+        fail(400);
+        return false;
+    }
+
+    std::string_view version = line.substr(second_space + 1);
+    if (version.size() != 8 || !version.starts_with("HTTP/1.")) {
+        fail(400);
+        return false;
+    }
+
+    auto offset = static_cast<std::uint32_t>(line_begin);
+    method_ = {offset, static_cast<std::uint32_t>(first_space)};
+    path_ = {static_cast<std::uint32_t>(offset + first_space + 1), static_cast<std::uint32_t>(second_space - first_space - 1)};
+    version_ = {static_cast<std::uint32_t>(offset + second_space + 1), 8};
+    return true;
+}
+
+bool Http_Parser::parse_header_line(std::string_view line, std::size_t line_begin) {
+    std::size_t colon = line.find(':');
+    // No name, whitespace before the colon or an obsolete folded line are all rejected (RFC 9112).
+    if (colon == std::string_view::npos || colon == 0 || line[colon - 1] == ' ' || line[0] == ' ' || line[0] == '\t') {
+        fail(400);
+        return false;
+    }
+    if (header_count_ == headers_.size()) {
+        fail(431);
+        return false;
+    }
+
+    std::string_view name = line.substr(0, colon);
+    std::string_view value = trim(line.substr(colon + 1));
+
+    if (iequals(name, "Content-Length")) {
+        std::size_t length = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), length);
+        // Repeated with another value, the body's end would be ambiguous: request smuggling (RFC 9112 6.3).
+        if (ec != std::errc() || end != value.data() + value.size() || (has_content_length_ && length != content_length_)) {
+            fail(400);
+            return false;
+        }
+        content_length_ = length;
+        has_content_length_ = true;
+    } else if (iequals(name, "Transfer-Encoding")) {
+        // Only chunked alone; a coding under it would have to be undone here.
+        if (!iequals(value, "chunked")) {
+            fail(501);
+            return false;
+        }
+        chunked_ = true;
+    }
+
+    auto value_offset = static_cast<std::uint32_t>(value.empty() ? line_begin + colon + 1 : line_begin + (value.data() - line.data()));
+    headers_[header_count_++] = {
+        {static_cast<std::uint32_t>(line_begin), static_cast<std::uint32_t>(colon)},
+        {value_offset, static_cast<std::uint32_t>(value.size())},
+    };
+    return true;
+}
+
+Http_Parser::Status Http_Parser::fail(int status) {
+    error_status_ = status;
+    return Status::Error;
+}
+
+void Http_Parser::reset() {
+    state_ = State::Request_Line;
+    scanned_ = 0;
+    line_begin_ = 0;
+    error_status_ = 0;
+    header_count_ = 0;
+    body_begin_ = 0;
+    content_length_ = 0;
+    has_content_length_ = false;
+    chunked_ = false;
+}
+
+void Body_Decoder::start(std::size_t content_length, bool chunked) {
+    state_ = chunked ? State::Size : content_length > 0 ? State::Length : State::Done;
+    remaining_ = chunked ? 0 : content_length;
+    size_digits_ = 0;
+    line_size_ = 0;
+    trailer_size_ = 0;
+}
+
+Body_Decoder::Status Body_Decoder::next(std::string_view data, std::size_t& consumed, std::string_view& piece) {
+    auto hex_digit = [](char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    auto take_payload = [&](std::size_t at) {
+        std::size_t size = static_cast<std::size_t>(std::min<std::uint64_t>(remaining_, data.size() - at));
+        piece = data.substr(at, size);
+        remaining_ -= size;
+        consumed = at + size;
+    };
+
+    piece = {};
+    std::size_t i = 0;
+    while (i < data.size()) {
+        switch (state_) {
+            case State::Length:
+                take_payload(i);
+                if (remaining_ > 0) return Status::Incomplete;
+                state_ = State::Done;
+                return Status::Complete;
+
+            case State::Size: {
+                int digit = hex_digit(data[i]);
+                if (digit >= 0) {
+                    if (++size_digits_ > 16) {          // would not fit 64 bits
+                        state_ = State::Error;
+                        break;
+                    }
+                    remaining_ = remaining_ * 16 + static_cast<std::uint64_t>(digit);
+                    ++i;
+                } else {
+                    char c = data[i];
+                    bool line_goes_on = c == ';' || c == '\r' || c == ' ' || c == '\t';
+                    state_ = size_digits_ > 0 && line_goes_on ? State::Size_Line : State::Error;
+                }
+                break;
+            }
+
+            case State::Size_Line:                      // extensions and CR up to the LF
+                if (data[i++] == '\n') {
+                    state_ = remaining_ == 0 ? State::Trailer : State::Data;
+                    size_digits_ = 0;
+                    line_size_ = 0;
+                } else if (++line_size_ > max_line_size) {
+                    state_ = State::Error;
+                }
+                break;
+
+            case State::Data:
+                take_payload(i);
+                if (remaining_ == 0) state_ = State::Data_CR;
+                return Status::Incomplete;
+
+            case State::Data_CR:
+                state_ = data[i++] == '\r' ? State::Data_LF : State::Error;
+                break;
+
+            case State::Data_LF:
+                state_ = data[i++] == '\n' ? State::Size : State::Error;
+                break;
+
+            case State::Trailer: {                      // header lines up to an empty one
+                char c = data[i++];
+                if (c == '\n') {
+                    if (line_size_ == 0) {
+                        state_ = State::Done;
+                        consumed = i;
+                        return Status::Complete;
+                    }
+                    line_size_ = 0;
+                } else if (c != '\r' && (++line_size_ > max_line_size || ++trailer_size_ > Http_Parser::max_head_size)) {
+                    state_ = State::Error;
+                }
+                break;
+            }
+
+            case State::Done:
+                consumed = i;
+                return Status::Complete;
+
+            case State::Error:
+                consumed = i;
+                return Status::Error;
+        }
+    }
+
+    consumed = i;
+    if (state_ == State::Error) return Status::Error;
+    return state_ == State::Done ? Status::Complete : Status::Incomplete;
+}
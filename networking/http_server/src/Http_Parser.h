@@ -0,0 +1,146 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+
+struct Http_Header {
+    std::string_view name;
+    std::string_view value;
+};
+
+// A parsed request. Every view points into the connection's receive buffer and
+// stays valid until those bytes are consumed. The server points `arena` at the
+// connection's arena, which lives until the response has been sent.
+struct Http_Request {
+    static constexpr std::size_t max_headers = 64;
+
+    std::string_view method;
+    std::string_view path;
+    std::string_view version;
+    std::array<Http_Header, max_headers> headers;
+    std::size_t header_count = 0;
+    std::string_view body;
+    std::pmr::memory_resource* arena = std::pmr::get_default_resource();   // for whatever answering it allocates
+
+    // Case-insensitive; empty if the header is missing.
+    std::string_view header(std::string_view name) const;
+};
+
+bool iequals(std::string_view a, std::string_view b);
+
+// Incremental HTTP/1.x request parser. parse() is called with all unconsumed
+// bytes of the connection every time more arrive; scanning resumes where the
+// previous call stopped, so a request split over many reads is scanned once.
+// The bytes may move between calls (buffer compaction), positions are kept
+// as offsets and turned into views only when the head is complete.
+//
+// A Content-Length body that is already there completes the request with it.
+// Otherwise (chunked, larger than max_body_size, or not received yet) parse()
+// returns Body once the head is complete: the caller reads the body from
+// head_size() on with a Body_Decoder, streaming it or collecting it as the route wants.
+class Http_Parser {
+public:
+    enum class Status { Complete, Incomplete, Error, Body };
+
+    static constexpr std::size_t max_head_size = 64 * 1024;
+    static constexpr std::size_t max_body_size = 1024 * 1024;
+
+    Status parse(std::string_view data, Http_Request& request);
+
+    // Size of the completed request, to be consumed from the buffer.
+    std::size_t request_size() const {
+        return body_begin_ + content_length_;
+    }
+
+    // For Status::Body: where the body starts and how it is framed.
+    std::size_t head_size() const {
+        return body_begin_;
+    }
+
+    std::size_t content_length() const {
+        return content_length_;
+    }
+
+    bool chunked() const {
+        return chunked_;
+    }
+
+    // Response status for Status::Error: 400, 431 or 501.
+    int error_status() const {
+        return error_status_;
+    }
+
+    // Ready for the next request, which starts at the beginning of the next parse() data.
+    void reset();
+
+private:
+    enum class State { Request_Line, Headers, Body };
+
+    struct Span {
+        std::uint32_t begin = 0;
+        std::uint32_t size = 0;
+    };
+
+    struct Header_Span {
+        Span name;
+        Span value;
+    };
+
+    Status fail(int status);
+    void fill(std::string_view data, Http_Request& request) const;
+    bool parse_request_line(std::string_view line, std::size_t line_begin);
+    bool parse_header_line(std::string_view line, std::size_t line_begin);
+
+private:
+    State state_ = State::Request_Line;
+    std::size_t scanned_ = 0;               // next byte to look at
+    std::size_t line_begin_ = 0;            // start of the line being scanned
+    int error_status_ = 0;
+
+    Span method_;
+    Span path_;
+    Span version_;
+    std::array<Header_Span, Http_Request::max_headers> headers_;
+    std::size_t header_count_ = 0;
+    std::size_t body_begin_ = 0;
+    std::size_t content_length_ = 0;
+    bool has_content_length_ = false;
+    bool chunked_ = false;
+};
+
+// Request body framing after the head: Content-Length bytes, or the chunked
+// transfer coding (chunk sizes, extensions and trailers are checked and
+// dropped). next() takes whatever has arrived and returns the payload as
+// views into it, so the body is never copied; it keeps its state between
+// reads, down to a chunk size split in the middle.
+class Body_Decoder {
+public:
+    enum class Status { Incomplete, Complete, Error };
+
+    static constexpr std::size_t max_line_size = 4096;      // chunk size line with extensions, trailer line
+
+    void start(std::size_t content_length, bool chunked);
+
+    // Consumes from the front of data up to and including the next payload
+    // piece (empty if there is none yet) or the end of the body.
+    Status next(std::string_view data, std::size_t& consumed, std::string_view& piece);
+
+private:
+    enum class State { Length, Size, Size_Line, Data, Data_CR, Data_LF, Trailer, Done, Error };
+
+    State state_ = State::Done;
+    std::uint64_t remaining_ = 0;           // of the body (Length) or of the chunk (Data)
+    std::size_t size_digits_ = 0;
+    std::size_t line_size_ = 0;
+    std::size_t trailer_size_ = 0;
+};
+
+// First '\n' in [begin, end), or end. Vectorized with SSE2 or NEON when available.
+const char* find_line_end(const char* begin, const char* end);
@@ -0,0 +1,159 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include "Compression.h"
+#include "Response_Batch.h"
+
+// A response whose status line, Content-Length, Content-Type and body never
+// change, serialized once at startup; only Date and Connection vary per request.
+// A compressible body gets a gzip-encoded twin, compressed once here.
+struct Static_Response {
+    Static_Response(int status, std::string_view content, std::string_view content_type = "text/plain",
+                    const Compression_Options& compression = {});
+
+    int status;
+    std::string head;
+    std::string content;
+    std::unique_ptr<const Static_Response> gzip;
+
+    // extra_headers: complete "Name: value\r\n" lines; never compressed.
+    Static_Response(int status, std::string_view content, std::string_view content_type, std::string_view extra_headers);
+};
+
+// A streamed body: appends the next piece to an empty string, returns false
+// with the last one. Called again only once the previous piece has been sent,
+// so one piece is in memory at a time whatever the body's size.
+using Body_Producer = std::function<bool(std::string& piece)>;
+
+// Content and headers live in `arena` (the request's, see Http_Request::arena),
+// so building a response costs no heap allocation; content_type is never copied.
+struct Http_Response {
+    Http_Response(int status = 200, std::string_view content = {}, std::string_view content_type = "text/plain",
+                  std::pmr::memory_resource* arena = std::pmr::get_default_resource())
+        : status(status), content(content, arena), content_type(content_type), extra_headers(arena) {}
+
+    int status;
+    std::pmr::string content;
+    std::string_view content_type;              // a literal, or bytes that outlive the response
+    std::pmr::string extra_headers;             // complete "Name: value\r\n" lines
+    const Static_Response* prepared = nullptr;  // set: sent as is, content and headers above unused
+    File_Body file = {};                        // set (owner): the body, instead of content
+    bool head_only = false;                     // HEAD: headers of the full response, no body
+    Body_Producer producer = {};                // set: the body, produced while it is sent (no Content-Length)
+
+    static Http_Response from(const Static_Response& prepared) {
+        Http_Response response{prepared.status, {}};
+        response.prepared = &prepared;
+        return response;
+    }
+
+    // Appends to the batch, so pipelined responses go out in one gather write.
+    // Moves the content out of a dynamic response. A producer's body is not
+    // added: it follows chunked on a keep-alive connection, up to the close otherwise.
+    void serialize(Response_Batch& out, bool keep_alive) {
+        if (prepared) {
+            out.add_static(prepared->head);
+        } else {
+            out.add_copy("HTTP/1.1 ");
+            out.add_number(static_cast<std::size_t>(status));
+            out.add_copy(" ");
+            out.add_copy(status_text(status));
+            out.add_copy("\r\n");
+            if (producer) {
+                if (keep_alive) out.add_copy("Transfer-Encoding: chunked\r\n");
+            } else if (status != 304) {
+                out.add_copy("Content-Length: ");
+                out.add_number(file.owner ? file.length : content.size());
+                out.add_copy("\r\n");
+            }
+            if (!content_type.empty()) {
+                out.add_copy("Content-Type: ");
+                out.add_copy(content_type);
+                out.add_copy("\r\n");
+            }
+            out.add_copy(extra_headers);
+        }
+        out.add_copy(date_header());
+        out.add_copy(keep_alive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n");
+        if (head_only || producer) {
+            return;
+        } else if (prepared) {
+            out.add_static(prepared->content);
+        } else if (file.owner) {
+            out.add_file(file);
+        } else {
+            out.add_owned(std::move(content));
+        }
+    }
+
+    static std::string_view status_text(int code) {
+        switch (code) {
+            case 200: return "OK";
+            case 206: return "Partial Content";
+            case 304: return "Not Modified";
+            case 400: return "Bad Request";
+            case 404: return "Not Found";
+            case 405: return "Method Not Allowed";
+            case 413: return "Content Too Large";
+            case 416: return "Range Not Satisfiable";
+            case 431: return "Request Header Fields Too Large";
+            case 500: return "Internal Server Error";
+            case 501: return "Not Implemented";
+            case 503: return "Service Unavailable";
+            default: return "Unknown";
+        }
+    }
+
+    // "Date: ...\r\n" of the current second. Formatted at most once per second
+    // per thread, the coarse clock read costs a few ns instead of a gmtime per request.
+    static std::string_view date_header() {
+        thread_local char line[64];
+        thread_local std::size_t size = 0;
+        thread_local std::time_t second = -1;
+
+        timespec now{};
+        clock_gettime(CLOCK_REALTIME_COARSE, &now);
+        if (now.tv_sec != second) {
+            std::tm time{};
+            gmtime_r(&now.tv_sec, &time);
+            size = std::strftime(line, sizeof(line), "Date: %a, %d %b %Y %H:%M:%S GMT\r\n", &time);
+            second = now.tv_sec;
+        }
+        return {line, size};
+    }
+};
+
+inline Static_Response::Static_Response(int status, std::string_view content, std::string_view content_type,
+                                        std::string_view extra_headers)
+    : status(status), content(content)
+{
+    head = "HTTP/1.1 " + std::to_string(status) + ' ';
+    head += Http_Response::status_text(status);
+    head += "\r\nContent-Length: " + std::to_string(content.size());
+    head += "\r\nContent-Type: ";
+    head += content_type;
+    head += "\r\n";
+    head += extra_headers;
+}
+
+inline Static_Response::Static_Response(int status, std::string_view content, std::string_view content_type,
+                                        const Compression_Options& compression)
+    : Static_Response(status, content, content_type, std::string_view())
+{
+    if (compression.level == 0 || content.size() < compression.min_size || !compressible(content_type)) return;
+
+    std::string compressed = ::gzip(content, compression.level);
+    if (compressed.size() >= content.size()) return;
+
+    head += "Vary: Accept-Encoding\r\n";
+    gzip.reset(new Static_Response(status, compressed, content_type, "Content-Encoding: gzip\r\nVary: Accept-Encoding\r\n"));
+}
@@ -0,0 +1,799 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Http_Server.h"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory_resource>
+#include <thread>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "Log_Limiter.h"
+
+// Access log budget: bursts up to 200 lines, then 100 lines/s with a
+// suppressed-lines summary, so logging stays on under load.
+static constexpr double access_log_rate = 100;
+static constexpr double access_log_burst = 200;
+
+// Grows (doubling) only for requests that do not fit; the parser caps the head
+// at 64 KB and the body at 1 MB, which bounds the buffer.
+static constexpr std::size_t initial_buffer_size = 4096;
+
+// Room behind the head for each read of a body that is received separately.
+static constexpr std::size_t body_read_size = 16 * 1024;
+
+// Pieces of /stream/{size}.
+static constexpr std::size_t stream_piece_size = 64 * 1024;
+
+// Responses of one batch are flushed early once they reach this size.
+static constexpr std::size_t max_batch_size = 64 * 1024;
+
+// Pause before accepting again when the process is out of descriptors or
+// memory; retrying at once only spins on the same error.
+static constexpr auto accept_backoff = std::chrono::milliseconds(50);
+
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+using receive_timestamps = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_TIMESTAMPNS>;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Accept errors that persist until something is freed, unlike per-connection
+    // ones such as ECONNABORTED.
+    bool out_of_resources(const boost::system::error_code& ec) {
+        return ec == boost::system::errc::too_many_files_open ||
+               ec == boost::system::errc::too_many_files_open_in_system ||
+               ec == boost::system::errc::no_buffer_space ||
+               ec == boost::system::errc::not_enough_memory;
+    }
+
+    // A response in the batch, recorded in the metrics once the batch is sent.
+    struct Answered {
+        std::size_t route;
+        int status;
+        Clock::time_point start;                // when its bytes were received
+    };
+
+    // Non-blocking read. With SO_TIMESTAMPNS the kernel attaches when it
+    // received the newest of these bytes, so `queued` is how long they waited
+    // in the socket buffer and behind the handlers ahead of this one (0 without it).
+    std::size_t receive(tcp::socket& socket, char* data, std::size_t size,
+                        std::chrono::nanoseconds& queued, boost::system::error_code& ec) {
+        iovec iov{data, size};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(timespec))];
+        msghdr message{};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t length = ::recvmsg(socket.native_handle(), &message, 0);
+        if (length < 0) {
+            ec = boost::system::error_code(errno, boost::asio::error::get_system_category());
+            return 0;
+        }
+        ec = length == 0 ? boost::asio::error::eof : boost::system::error_code();
+
+        queued = std::chrono::nanoseconds(0);
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level != SOL_SOCKET || header->cmsg_type != SCM_TIMESTAMPNS) continue;
+            timespec received{};
+            std::memcpy(&received, CMSG_DATA(header), sizeof(received));
+            timespec now{};
+            clock_gettime(CLOCK_REALTIME, &now);
+            queued = std::max(std::chrono::nanoseconds(0),
+                              std::chrono::seconds(now.tv_sec - received.tv_sec) +
+                              std::chrono::nanoseconds(now.tv_nsec - received.tv_nsec));
+        }
+        return static_cast<std::size_t>(length);
+    }
+
+    // Most batches fit in the send buffer and go out from Response_Batch::send()
+    // with no asynchronous operation (nor its allocations); only a full buffer waits here.
+    awaitable<void> write_rest(tcp::socket& socket, Response_Batch& out) {
+        do {
+            co_await socket.async_wait(tcp::socket::wait_write, boost::asio::use_awaitable);
+        } while (!out.send(socket));
+    }
+
+    // A producer's body after the batch holding its head: every piece is sent
+    // (waiting for the socket if need be) before the next one is produced, as a
+    // chunk or raw up to the close. A producer that throws leaves the body
+    // unterminated, so the client sees it is incomplete.
+    awaitable<void> send_stream(tcp::socket& socket, Response_Batch& out, const Body_Producer& producer, bool chunked) {
+        std::string piece;
+        char size_line[20];
+        for (bool more = true; more;) {
+            piece.clear();
+            more = producer(piece);
+            if (!piece.empty()) {
+                if (chunked) {
+                    char* end = std::to_chars(size_line, size_line + 16, piece.size(), 16).ptr;
+                    *end++ = '\r';
+                    *end++ = '\n';
+                    out.add_copy({size_line, static_cast<std::size_t>(end - size_line)});
+                }
+                out.add_static(piece);
+                if (chunked) out.add_copy("\r\n");
+            }
+            if (!more && chunked) out.add_copy("0\r\n\r\n");
+            if (!out.send(socket)) co_await write_rest(socket, out);
+            out.clear();
+        }
+    }
+}
+
+// Shared with the idle timer's handler, which may still be queued when the coroutine ends.
+struct Http_Server::Connection {
+    explicit Connection(tcp::socket s): socket(std::move(s)), idle(socket.get_executor()) {}
+
+    tcp::socket socket;
+    boost::asio::steady_timer idle;
+    Clock::time_point deadline = Clock::time_point::max();     // max: not waiting for the client
+    bool idle_armed = false;
+
+    // The timer is not re-armed per read: reads only move the deadline, and a
+    // wait that fires early re-arms itself for the current one. So a busy
+    // connection costs one timer operation per idle timeout, not one per request.
+    static void arm_idle_timer(const std::shared_ptr<Connection>& connection) {
+        connection->idle_armed = true;
+        connection->idle.expires_at(connection->deadline);
+        connection->idle.async_wait([connection](boost::system::error_code ec) {
+            connection->idle_armed = false;
+            if (ec) return;
+            if (connection->deadline <= Clock::now()) {
+                connection->socket.cancel();
+            } else if (connection->deadline != Clock::time_point::max()) {
+                arm_idle_timer(connection);
+            }
+        });
+    }
+};
+
+// Requests are parsed in place: [begin, end) of the buffer holds bytes not yet
+// consumed, the parser's views point into it until the request is answered.
+struct Http_Server::Input {
+    std::vector<char> buffer = std::vector<char>(initial_buffer_size);
+    std::size_t begin = 0;
+    std::size_t end = 0;
+    std::size_t received = 0;                   // bytes read, not yet added to the metrics
+
+    std::string_view unconsumed() const {
+        return {buffer.data() + begin, end - begin};
+    }
+};
+
+Http_Server::Http_Server(unsigned short port, const Http_Options& options)
+    : options_(options),
+      static_files_(options_.static_root.empty() ? nullptr
+                    : std::make_unique<Static_Files>(options_.static_root, options_.static_files, options_.compression)),
+      router_(make_router()),
+      unavailable_(503, "Service Unavailable", "text/plain",
+                   "Retry-After: " + std::to_string(options_.admission.retry_after.count()) + "\r\n")
+{
+    tcp::endpoint endpoint(tcp::v4(), port);
+    for (std::size_t i = 0; i < options_.threads; ++i) {
+        auto& io = contexts_.emplace_back(std::make_unique<boost::asio::io_context>(1));
+        auto& acceptor = acceptors_.emplace_back(std::make_unique<tcp::acceptor>(*io));
+
+        acceptor->open(endpoint.protocol());
+        acceptor->set_option(tcp::acceptor::reuse_address(true));
+        acceptor->set_option(reuse_port(true));
+        acceptor->bind(endpoint);
+        acceptor->listen(boost::asio::socket_base::max_listen_connections);
+        // Inherited by accepted sockets.
+        if (options_.admission.max_queue_time.count() != 0) acceptor->set_option(receive_timestamps(true));
+
+        admissions_.push_back(std::make_unique<Admission>(*io, options_.admission, options_.threads));
+        metrics_.push_back(std::make_unique<Metrics>(router_.route_count()));
+    }
+
+    std::cout << "Server started with port: " << port << " (" << options_.threads << " threads)\n";
+}
+
+void Http_Server::run() {
+    for (std::size_t i = 0; i < contexts_.size(); ++i) {
+        boost::asio::co_spawn(*contexts_[i], listen(*acceptors_[i], *admissions_[i], *metrics_[i]), boost::asio::detached);
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& context : contexts_) {
+        threads.emplace_back([&context]() { context->run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void Http_Server::stop() {
+    for (auto& context : contexts_) {
+        context->stop();
+    }
+}
+
+// In pause mode a full thread stops accepting, the kernel backlog holds the
+// rest; otherwise connections over the limit are answered 503 and closed.
+awaitable<void> Http_Server::listen(tcp::acceptor& acceptor, Admission& admission, Metrics& metrics) {
+    for (;;) {
+        if (options_.admission.pause_accept) co_await admission.wait_for_slot();
+
+        boost::system::error_code ec;
+        tcp::socket socket = co_await acceptor.async_accept(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+        if (ec) {
+            LOG_RATE_LIMITED(logger, 10, 10, "Accept error: {}", ec.message());
+            if (out_of_resources(ec)) {
+                boost::asio::steady_timer backoff(acceptor.get_executor(), accept_backoff);
+                co_await backoff.async_wait(boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+            }
+            continue;
+        }
+        if (!admission.open_connection()) {
+            reject(socket, admission, metrics);
+            continue;
+        }
+        boost::asio::co_spawn(acceptor.get_executor(), handle_client(std::move(socket), admission, metrics), boost::asio::detached);
+    }
+}
+
+// One non-blocking write into the empty send buffer, then close. Whatever the
+// client already sent is read and dropped first: closing with unread bytes
+// would reset the connection and could discard the 503.
+void Http_Server::reject(tcp::socket& socket, const Admission& admission, Metrics& metrics) const {
+    boost::system::error_code ec;
+    socket.non_blocking(true, ec);
+
+    Response_Batch out;
+    Http_Response::from(unavailable_).serialize(out, false);
+    out.send(socket);
+
+    char discard[4096];
+    std::size_t received = 0;
+    while (std::size_t length = socket.read_some(boost::asio::buffer(discard), ec)) received += length;
+    socket.shutdown(tcp::socket::shutdown_send, ec);
+    socket.close(ec);
+
+    metrics.reject_connection();
+    metrics.add_bytes(received, out.take_sent_bytes());
+    LOG_RATE_LIMITED(logger, 1, 1, "Connection rejected (503): {} open, queue time {} us",
+                     open_connections(), std::chrono::duration_cast<std::chrono::microseconds>(admission.queue_time()).count());
+}
+
+// Every request complete after a read is answered before the next read, and
+// all of their responses go out in one gather write (pipelining). A body that
+// does not come with its head is read by receive_body() before answering.
+//
+// Whatever answering allocates (response bodies and headers, collected request
+// bodies) comes from the connection's arena, a bump allocator over one buffer
+// that is reset as a whole once the responses referencing it are sent. Parsing
+// and routing only keep views, so a warmed-up connection makes no heap allocation
+// per request; a batch that outgrows the buffer borrows from the heap until the reset.
+//
+// A request's latency runs from when its bytes were received (the kernel's
+// timestamp with SO_TIMESTAMPNS, the end of the read otherwise) to when its
+// batch is written; it is recorded with the route and status once the batch is sent.
+awaitable<void> Http_Server::handle_client(tcp::socket socket, Admission& admission, Metrics& metrics) const {
+    metrics.open_connection();
+    auto connection = std::make_shared<Connection>(std::move(socket));
+    Input in;
+    // Before `out`, which may still hold bodies from it when an exception ends the connection.
+    std::vector<std::byte> arena_buffer(options_.request_arena_size);
+    std::pmr::monotonic_buffer_resource arena(arena_buffer.data(), arena_buffer.size());
+    Response_Batch out;
+    std::vector<Answered> answered;
+    std::size_t unanswered = 0;    // parsed requests not yet recorded
+    std::size_t in_flight = 0;     // admitted requests of the batch not yet sent
+    try {
+        connection->socket.non_blocking(true);
+
+        std::size_t served = 0;
+        Http_Parser parser;
+        Http_Request request;
+        bool open = true;
+        if (!arena_buffer.empty()) request.arena = &arena;
+
+        auto flush = [&]() {
+            Clock::time_point sent = Clock::now();
+            for (const Answered& response : answered) metrics.end_request(response.route, response.status, sent - response.start);
+            unanswered -= answered.size();
+            answered.clear();
+            metrics.add_bytes(std::exchange(in.received, 0), out.take_sent_bytes());
+            out.clear();
+            arena.release();
+            admission.end_requests(in_flight);
+            in_flight = 0;
+        };
+
+        while (open) {
+            // The wait is awaited here, not in a nested coroutine: asio keeps one
+            // spare coroutine frame per thread, which the wait's own frame reuses.
+            std::chrono::nanoseconds queued{0};
+            Read_Status read;
+            boost::system::error_code ec;
+            while ((read = read_available(connection, in, queued)) == Read_Status::Wait) {
+                co_await connection->socket.async_wait(tcp::socket::wait_read,
+                                                       boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+                if (ec) break;
+            }
+            if (read != Read_Status::Data) break;
+            Clock::time_point received = Clock::now() - queued;
+
+            while (open && in.begin < in.end) {
+                auto status = parser.parse(in.unconsumed(), request);
+                if (status == Http_Parser::Status::Incomplete) break;
+                metrics.begin_request();
+                ++unanswered;
+
+                if (status == Http_Parser::Status::Error) {
+                    Http_Response response(parser.error_status(), Http_Response::status_text(parser.error_status()));
+                    response.serialize(out, false);
+                    answered.push_back({router_.route_count(), response.status, received});
+                    open = false;
+                    break;
+                }
+
+                bool admitted = admission.begin_request(queued);
+                in_flight += admitted;
+                open = keep_alive(request) && ++served < options_.max_requests_per_connection;
+
+                Route_Match match = match_route(request);
+                Http_Response response(200, {}, {}, request.arena);
+                std::size_t request_end = in.begin + parser.request_size();
+                if (!admitted) {
+                    // A shed request is still answered in order, so the connection stays
+                    // usable, unless a body it came with would have to be read first.
+                    response = Http_Response::from(unavailable_);
+                    if (status == Http_Parser::Status::Body) {
+                        open = false;
+                        request_end = in.end;
+                    }
+                } else if (status == Http_Parser::Status::Complete) {
+                    response = route(request, match);
+                } else {
+                    // Earlier responses go out first, the client may wait for them before sending the body.
+                    if (!out.empty()) {
+                        if (!out.send(connection->socket)) co_await write_rest(connection->socket, out);
+                        --in_flight;
+                        flush();
+                        in_flight = 1;
+                    }
+                    bool body_read = true;
+                    response = co_await receive_body(connection, in, parser, request, out, request_end, body_read);
+                    open = open && body_read;
+                }
+                request_info(request, response);
+                answered.push_back({match.handler ? match.route : router_.route_count(), response.status, received});
+
+                // HEAD gets the headers of what GET would get, whichever route or error answered it.
+                if (request.method == "HEAD") response.head_only = true;
+                // Without chunked coding (HTTP/1.0) a streamed body ends with the connection.
+                if (response.producer && request.version == "HTTP/1.0") open = false;
+                response.serialize(out, open);
+                if (response.producer && !response.head_only) {
+                    co_await send_stream(connection->socket, out, response.producer, open);
+                    flush();
+                }
+                in.begin = request_end;
+                parser.reset();
+
+                if (out.size() >= max_batch_size) {
+                    if (!out.send(connection->socket)) co_await write_rest(connection->socket, out);
+                    flush();
+                }
+            }
+
+            if (!out.empty()) {
+                if (!out.send(connection->socket)) co_await write_rest(connection->socket, out);
+                flush();
+            }
+            if (in.begin == in.end) in.begin = in.end = 0;
+        }
+
+        // Half-close first so the last response is not cut off by a reset.
+        boost::system::error_code ec;
+        connection->socket.shutdown(tcp::socket::shutdown_send, ec);
+
+    } catch (std::exception& e) {
+        LOG_RATE_LIMITED(logger, access_log_rate, access_log_burst, "Client error: {}", e.what());
+    }
+    connection->deadline = Clock::time_point::max();
+    connection->idle.cancel();
+    admission.end_requests(in_flight);
+    admission.close_connection();
+    metrics.abandon_requests(unanswered);
+    metrics.add_bytes(in.received, out.take_sent_bytes());
+    metrics.close_connection();
+}
+
+// Makes room first: consumed bytes are compacted away, the buffer doubles only
+// for a request that does not fit. Bytes already there (pipelined clients) are
+// read right away; otherwise it returns Wait with the idle timer set, the caller
+// waits for readability and calls again. The timer cancels that wait if nothing
+// arrives before the deadline. Closed once the client is gone.
+Http_Server::Read_Status Http_Server::read_available(const std::shared_ptr<Connection>& connection, Input& in,
+                                                     std::chrono::nanoseconds& queued) const {
+    connection->deadline = Clock::time_point::max();
+    if (in.end == in.buffer.size()) {
+        if (in.begin > 0) {
+            std::memmove(in.buffer.data(), in.buffer.data() + in.begin, in.end - in.begin);
+            in.end -= in.begin;
+            in.begin = 0;
+        } else {
+            in.buffer.resize(in.buffer.size() * 2);
+        }
+    }
+
+    boost::system::error_code ec;
+    std::size_t length = receive(connection->socket, in.buffer.data() + in.end, in.buffer.size() - in.end, queued, ec);
+    if (ec == boost::asio::error::would_block) {
+        connection->deadline = Clock::now() + options_.idle_timeout;
+        if (!connection->idle_armed) Connection::arm_idle_timer(connection);
+        return Read_Status::Wait;
+    }
+    if (ec == boost::asio::error::eof || ec == boost::asio::error::connection_reset) return Read_Status::Closed;
+    if (ec) throw boost::system::system_error(ec);
+    in.end += length;
+    in.received += length;
+    return Read_Status::Data;
+}
+
+// The body of the request at in.begin that did not come with its head
+// (chunked, larger than the parser waits for, or still arriving). A streaming
+// route gets it piece by piece as it arrives; any other route gets it collected
+// into request.body, up to Http_Parser::max_body_size. The head stays at the
+// start of the buffer and every read of body lands right behind it, so a
+// stream needs the head and one read of memory whatever the body's size.
+// Answers that leave the body unread (404, 413, bad framing, handler errors)
+// clear `open`; request_end is set past the body otherwise.
+awaitable<Http_Response> Http_Server::receive_body(const std::shared_ptr<Connection>& connection, Input& in,
+                                                   Http_Parser& parser, Http_Request& request, Response_Batch& out,
+                                                   std::size_t& request_end, bool& open) const {
+    std::size_t head_size = parser.head_size();
+    if (in.begin > 0 || in.buffer.size() < head_size + body_read_size) {
+        std::memmove(in.buffer.data(), in.buffer.data() + in.begin, in.end - in.begin);
+        in.end -= in.begin;
+        in.begin = 0;
+        if (in.buffer.size() < head_size + body_read_size) in.buffer.resize(head_size + body_read_size);
+        parser.parse(in.unconsumed(), request);         // views into the moved head
+    }
+
+    Route_Match match = match_route(request);
+    if (!match.handler) {
+        open = false;
+        co_return route(request, match);
+    }
+    if (!match.body_handler && !parser.chunked() && parser.content_length() > Http_Parser::max_body_size) {
+        open = false;
+        co_return Http_Response(413, "Content Too Large");
+    }
+
+    // A client that asked may hold the body back until told to go ahead.
+    if (request.version != "HTTP/1.0" && iequals(request.header("Expect"), "100-continue")) {
+        out.add_static("HTTP/1.1 100 Continue\r\n\r\n");
+        if (!out.send(connection->socket)) co_await write_rest(connection->socket, out);
+        out.clear();
+    }
+
+    try {
+        Body_Reader reader;
+        std::pmr::string body(request.arena);
+        if (match.body_handler) {
+            reader = (*match.body_handler)(request, match.params);
+        } else if (!parser.chunked()) {
+            body.reserve(parser.content_length());
+        }
+
+        Body_Decoder decoder;
+        decoder.start(parser.content_length(), parser.chunked());
+        std::size_t position = head_size;
+        for (;;) {
+            std::size_t consumed = 0;
+            std::string_view piece;
+            auto status = decoder.next({in.buffer.data() + position, in.end - position}, consumed, piece);
+            position += consumed;
+
+            if (!piece.empty()) {
+                if (match.body_handler) {
+                    reader.on_data(piece);
+                } else if (body.size() + piece.size() > Http_Parser::max_body_size) {
+                    open = false;
+                    co_return Http_Response(413, "Content Too Large");
+                } else {
+                    body.append(piece);
+                }
+            }
+            if (status == Body_Decoder::Status::Error) {
+                open = false;
+                co_return Http_Response(400, "Bad Request");
+            }
+            if (status == Body_Decoder::Status::Complete) break;
+            if (position < in.end) continue;
+
+            // All consumed: the next read goes behind the head again.
+            in.end = position = head_size;
+            std::chrono::nanoseconds queued{0};
+            Read_Status read;
+            boost::system::error_code ec;
+            while ((read = read_available(connection, in, queued)) == Read_Status::Wait) {
+                co_await connection->socket.async_wait(tcp::socket::wait_read,
+                                                       boost::asio::redirect_error(boost::asio::use_awaitable, ec));
+                if (ec) break;
+            }
+            if (read != Read_Status::Data) {
+                throw boost::system::system_error(boost::asio::error::eof, "connection closed inside a request body");
+            }
+        }
+
+        request_end = position;
+        if (match.body_handler) co_return reader.finish();
+        request.body = body;
+        co_return route(request, match);
+
+    } catch (boost::system::system_error&) {
+        throw;
+    } catch (...) {
+        open = false;
+        co_return Http_Response(500, "Internal Server Error");
+    }
+}
+
+// HTTP/1.1 keeps the connection unless the client says close, HTTP/1.0 only if it asks for keep-alive.
+bool Http_Server::keep_alive(const Http_Request& request) {
+    std::string_view connection = request.header("Connection");
+    if (request.version == "HTTP/1.0") return iequals(connection, "keep-alive");
+    return !iequals(connection, "close");
+}
+
+// A JSON catalogue big enough to be worth compressing.
+static std::string make_items() {
+    std::string items = "[";
+    for (int i = 0; i < 200; ++i) {
+        if (i > 0) items += ',';
+        items += R"({"id":)" + std::to_string(i) + R"(,"name":"item )" + std::to_string(i) +
+                 R"(","price":)" + std::to_string(100 + i * 7 % 900) + R"(,"tags":["sale","new"],"in_stock":true})";
+    }
+    items += "]";
+    return items;
+}
+
+Router Http_Server::make_router() {
+    Router router;
+
+    auto add_static = [&](std::string_view pattern, std::unique_ptr<const Static_Response> response) {
+        const Static_Response* prepared = static_responses_.emplace_back(std::move(response)).get();
+        router.add(Http_Method::Get, pattern, [prepared](const Http_Request&, const Route_Params&) {
+            return Http_Response::from(*prepared);
+        });
+    };
+    add_static("/hello", std::make_unique<Static_Response>(200, "Hello World"));
+    add_static("/json", std::make_unique<Static_Response>(200, R"({"msg":"hi"})", "application/json"));
+    add_static("/items", std::make_unique<Static_Response>(200, make_items(), "application/json", options_.compression));
+
+    router.add(Http_Method::Get, "/users/{id}", [](const Http_Request& request, const Route_Params& params) {
+        Http_Response response(200, R"({"id":")", "application/json", request.arena);
+        response.content.append(params.get("id")).append("\"}");
+        return response;
+    });
+
+    // Streams the body through CRC-32 as it arrives, whatever its size.
+    router.add_streaming(Http_Method::Post, "/upload", [](const Http_Request& request, const Route_Params&) {
+        struct Digest {
+            std::size_t bytes = 0;
+            uLong crc = crc32(0, nullptr, 0);
+        };
+        auto digest = std::make_shared<Digest>();
+        return Body_Reader{
+            [digest](std::string_view piece) {
+                digest->bytes += piece.size();
+                digest->crc = crc32(digest->crc, reinterpret_cast<const Bytef*>(piece.data()), static_cast<uInt>(piece.size()));
+            },
+            [digest, arena = request.arena]() {
+                char crc[9];
+                char* end = std::to_chars(crc, crc + 8, digest->crc, 16).ptr;
+                Http_Response response(200, R"({"bytes":)", "application/json", arena);
+                response.content.append(std::to_string(digest->bytes)).append(R"(,"crc32":")");
+                response.content.append(8 - static_cast<std::size_t>(end - crc), '0').append(crc, end).append("\"}");
+                return response;
+            },
+        };
+    });
+
+    // The body back, collected in memory first (up to 1 MB).
+    router.add(Http_Method::Post, "/echo", [](const Http_Request& request, const Route_Params&) {
+        return Http_Response(200, request.body, "application/octet-stream", request.arena);
+    });
+
+    // {size} bytes of text, produced 64 KB at a time while they are sent.
+    router.add(Http_Method::Get, "/stream/{size}", [](const Http_Request&, const Route_Params& params) {
+        std::string_view text = params.get("size");
+        std::size_t size = 0;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), size);
+        if (ec != std::errc() || end != text.data() + text.size()) return Http_Response(400, "Bad Request");
+
+        Http_Response response;
+        response.producer = [remaining = size](std::string& piece) mutable {
+            static constexpr std::string_view line = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ.\n";
+            std::size_t length = std::min(remaining, stream_piece_size);
+            while (piece.size() < length) piece.append(line.substr(0, length - piece.size()));
+            remaining -= length;
+            return remaining > 0;
+        };
+        return response;
+    });
+
+    // Prometheus text format, every thread's shard merged per scrape.
+    router.add(Http_Method::Get, "/metrics", [this](const Http_Request& request, const Route_Params&) {
+        Http_Response response(200, {}, "text/plain; version=0.0.4", request.arena);
+        write_metrics(response.content);
+        return response;
+    });
+
+    if (static_files_) {
+        Static_Files* files = static_files_.get();
+        router.add(Http_Method::Get, "/static/{*path}", [files](const Http_Request& request, const Route_Params& params) {
+            return files->serve(request, params.get("path"), false);
+        });
+        router.add(Http_Method::Head, "/static/{*path}", [files](const Http_Request& request, const Route_Params& params) {
+            return files->serve(request, params.get("path"), true);
+        });
+    }
+
+    router.compile();
+    return router;
+}
+
+Route_Match Http_Server::match_route(const Http_Request& request) const {
+    std::string_view path = request.path.substr(0, request.path.find('?'));
+    return router_.match(parse_method(request.method), path);
+}
+
+Http_Response Http_Server::route(const Http_Request& request, const Route_Match& match) const {
+    Http_Response response(200, {}, {}, request.arena);
+
+    try {
+        if (match.handler) {
+            response = (*match.handler)(request, match.params);
+            compress(request, response);
+        } else if (match.path_found) {
+            response = {405, "Method Not Allowed"};
+            response.extra_headers.append("Allow: ").append(Router::allow_header(match.allowed_methods)).append("\r\n");
+        } else {
+            response = {404, "Not Found"};
+        }
+    } catch (...) {
+        response = {500, "Internal Server Error"};
+    }
+
+    return response;
+}
+
+// The gzip twin of a static response, or the body of a dynamic one compressed
+// per request; static files negotiate their own encoding.
+void Http_Server::compress(const Http_Request& request, Http_Response& response) const {
+    const Compression_Options& compression = options_.compression;
+    if (compression.level == 0) return;
+
+    if (response.prepared) {
+        if (response.prepared->gzip && accepts_gzip(request.header("Accept-Encoding"))) {
+            response.prepared = response.prepared->gzip.get();
+        }
+        return;
+    }
+
+    if (response.file.owner || response.head_only || response.content.size() < compression.min_size ||
+        !compressible(response.content_type)) return;
+
+    response.extra_headers += "Vary: Accept-Encoding\r\n";
+    if (!accepts_gzip(request.header("Accept-Encoding"))) return;
+
+    std::string compressed = gzip(response.content, compression.level);
+    if (compressed.size() >= response.content.size()) return;
+    response.content = compressed;
+    response.extra_headers += "Content-Encoding: gzip\r\n";
+}
+
+void Http_Server::request_info(const Http_Request& request, const Http_Response& response) const {
+    LOG_RATE_LIMITED(logger, access_log_rate, access_log_burst, "{} {} -> {} {} Active clients: {}",
+                     request.method, request.path, response.status,
+                     Http_Response::status_text(response.status), open_connections());
+}
+
+void Http_Server::write_metrics(std::pmr::string& out) const {
+    Metrics::Totals totals;
+    totals.routes.resize(router_.route_count() + 1);
+    for (const auto& shard : metrics_) shard->add_to(totals);
+
+    // Listening sockets report their accept queue: length and backlog limit.
+    std::uint64_t accept_queue = 0;
+    std::uint64_t accept_queue_limit = 0;
+    for (const auto& acceptor : acceptors_) {
+        tcp_info info{};
+        socklen_t size = sizeof(info);
+        if (getsockopt(acceptor->native_handle(), IPPROTO_TCP, TCP_INFO, &info, &size) == 0) {
+            accept_queue += info.tcpi_unacked;
+            accept_queue_limit += info.tcpi_sacked;
+        }
+    }
+
+    auto number = [&out](auto value) {
+        char digits[32];
+        out.append(digits, std::to_chars(digits, digits + sizeof(digits), value).ptr);
+    };
+    auto labels = [&](std::size_t route) {
+        if (route == router_.route_count()) {
+            out.append("{route=\"unmatched\"");
+        } else {
+            out.append("{method=\"").append(Router::method_name(router_.route_method(route)))
+               .append("\",route=\"").append(router_.route_pattern(route)).append("\"");
+        }
+    };
+    auto sample = [&](std::string_view name, std::string_view help, std::string_view type, std::uint64_t value) {
+        out.append("# HELP ").append(name).append(" ").append(help).append("\n# TYPE ").append(name)
+           .append(" ").append(type).append("\n").append(name).append(" ");
+        number(value);
+        out.append("\n");
+    };
+
+    out.append("# HELP http_requests_total Requests answered, by route and status.\n"
+               "# TYPE http_requests_total counter\n");
+    for (std::size_t r = 0; r < totals.routes.size(); ++r) {
+        const auto& requests = totals.routes[r].requests;
+        for (std::size_t i = 0; i < requests.size(); ++i) {
+            if (requests[i] == 0) continue;
+            out.append("http_requests_total");
+            labels(r);
+            out.append(",status=\"");
+            if (i < Metrics::statuses.size()) {
+                number(Metrics::statuses[i]);
+            } else {
+                out.append("other");
+            }
+            out.append("\"} ");
+            number(requests[i]);
+            out.append("\n");
+        }
+    }
+
+    out.append("# HELP http_request_duration_seconds From receiving a request to writing its response.\n"
+               "# TYPE http_request_duration_seconds histogram\n");
+    for (std::size_t r = 0; r < totals.routes.size(); ++r) {
+        const Metrics::Route_Totals& route = totals.routes[r];
+        if (std::all_of(route.buckets.begin(), route.buckets.end(), [](std::uint64_t n) { return n == 0; })) continue;
+        std::uint64_t count = 0;
+        for (std::size_t i = 0; i < route.buckets.size(); ++i) {
+            count += route.buckets[i];
+            out.append("http_request_duration_seconds_bucket");
+            labels(r);
+            out.append(",le=\"").append(i < Metrics::bucket_labels.size() ? Metrics::bucket_labels[i] : "+Inf").append("\"} ");
+            number(count);
+            out.append("\n");
+        }
+        out.append("http_request_duration_seconds_sum");
+        labels(r);
+        out.append("} ");
+        number(static_cast<double>(route.latency_ns) / 1e9);
+        out.append("\nhttp_request_duration_seconds_count");
+        labels(r);
+        out.append("} ");
+        number(count);
+        out.append("\n");
+    }
+
+    sample("http_requests_in_flight", "Requests parsed and not yet answered.", "gauge", totals.in_flight);
+    sample("http_connections", "Open client connections.", "gauge", totals.connections);
+    sample("http_connections_rejected_total", "Connections answered 503 and closed at accept.", "counter",
+           totals.rejected_connections);
+    sample("http_accept_queue_length", "Connections waiting in the listen backlogs.", "gauge", accept_queue);
+    sample("http_accept_queue_limit", "Size of the listen backlogs.", "gauge", accept_queue_limit);
+    sample("http_received_bytes_total", "Bytes read from clients.", "counter", totals.bytes_in);
+    sample("http_sent_bytes_total", "Bytes written to clients.", "counter", totals.bytes_out);
+}
+
+std::uint64_t Http_Server::open_connections() const {
+    std::uint64_t open = 0;
+    for (const auto& shard : metrics_) open += shard->connections();
+    return open;
+}
@@ -0,0 +1,83 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <boost/asio.hpp>
+#include "Admission.h"
+#include "Http_Parser.h"
+#include "Http_Response.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Router.h"
+#include "Static_Files.h"
+
+using boost::asio::ip::tcp;
+
+// Defined in main.cpp.
+extern Logger logger;
+
+using boost::asio::awaitable;
+
+struct Http_Options {
+    std::size_t threads = 1;                            // one io_context and one SO_REUSEPORT acceptor each
+    std::chrono::milliseconds idle_timeout{5000};       // no bytes from the client for this long -> close
+    std::size_t max_requests_per_connection = 1000;     // the last one is answered with Connection: close
+    std::string static_root;                            // served under /static/ if set
+    Static_Files_Options static_files;
+    Compression_Options compression;                    // gzip for static responses, static files and dynamic bodies
+    Admission_Options admission;                        // connection, in-flight and queueing limits, 503 past them
+    std::size_t request_arena_size = 4096;              // per connection, what answering a batch allocates; 0: the heap
+};
+
+// Coroutine server: every thread runs its own io_context with its own
+// SO_REUSEPORT acceptor, the kernel spreads connections over them and a
+// connection never leaves the thread that accepted it. Each connection is one
+// coroutine, so an idle keep-alive connection costs a suspended frame, not a thread.
+// Each thread sheds load on its own (Admission): past its limits new connections
+// and requests get a pre-serialized 503, so work that is accepted stays fast.
+// Each thread also records into its own Metrics shard; GET /metrics merges them.
+class Http_Server {
+public:
+    Http_Server(unsigned short port, const Http_Options& options = {});
+    void run();
+    void stop();                                        // run() returns once every thread has stopped
+
+private:
+    struct Connection;
+    struct Input;
+
+    awaitable<void> listen(tcp::acceptor& acceptor, Admission& admission, Metrics& metrics);
+    awaitable<void> handle_client(tcp::socket socket, Admission& admission, Metrics& metrics) const;
+    enum class Read_Status { Data, Wait, Closed };
+
+    Read_Status read_available(const std::shared_ptr<Connection>& connection, Input& in,
+                               std::chrono::nanoseconds& queued) const;
+    awaitable<Http_Response> receive_body(const std::shared_ptr<Connection>& connection, Input& in,
+                                          Http_Parser& parser, Http_Request& request, Response_Batch& out,
+                                          std::size_t& request_end, bool& open) const;
+    void reject(tcp::socket& socket, const Admission& admission, Metrics& metrics) const;
+    static bool keep_alive(const Http_Request& request);
+    Router make_router();
+    Route_Match match_route(const Http_Request& request) const;
+    Http_Response route(const Http_Request& request, const Route_Match& match) const;
+    void compress(const Http_Request& request, Http_Response& response) const;
+    void request_info(const Http_Request& request, const Http_Response& response) const;
+    void write_metrics(std::pmr::string& out) const;
+    std::uint64_t open_connections() const;
+
+private:
+    Http_Options options_;
+    std::unique_ptr<Static_Files> static_files_;
+    std::vector<std::unique_ptr<const Static_Response>> static_responses_;     // referenced by router_
+    Router router_;
+    Static_Response unavailable_;                       // 503 with Retry-After
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts_;
+    std::vector<std::unique_ptr<tcp::acceptor>> acceptors_;
+    std::vector<std::unique_ptr<Admission>> admissions_;
+    std::vector<std::unique_ptr<Metrics>> metrics_;     // one shard per thread
+};
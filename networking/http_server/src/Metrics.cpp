@@ -0,0 +1,39 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Metrics.h"
+#include <algorithm>
+
+Metrics::Metrics(std::size_t routes) : routes_(routes + 1) {}
+
+void Metrics::end_request(std::size_t route, int status, Clock::duration latency) {
+    Route_Counters& counters = routes_[std::min(route, routes_.size() - 1)];
+
+    auto known = std::find(statuses.begin(), statuses.end(), status);
+    add(counters.requests[static_cast<std::size_t>(known - statuses.begin())], 1);
+
+    auto ns = std::max<std::int64_t>(0, std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count());
+    auto bucket = std::lower_bound(bucket_bounds.begin(), bucket_bounds.end(), ns);
+    add(counters.buckets[static_cast<std::size_t>(bucket - bucket_bounds.begin())], 1);
+    add(counters.latency_ns, static_cast<std::uint64_t>(ns));
+
+    add(in_flight_, -1);
+}
+
+void Metrics::add_to(Totals& totals) const {
+    auto load = [](const Counter& counter) { return counter.load(std::memory_order_relaxed); };
+
+    for (std::size_t r = 0; r < routes_.size(); ++r) {
+        const Route_Counters& counters = routes_[r];
+        Route_Totals& route = totals.routes[r];
+        for (std::size_t i = 0; i < counters.requests.size(); ++i) route.requests[i] += load(counters.requests[i]);
+        for (std::size_t i = 0; i < counters.buckets.size(); ++i) route.buckets[i] += load(counters.buckets[i]);
+        route.latency_ns += load(counters.latency_ns);
+    }
+    totals.in_flight += load(in_flight_);
+    totals.connections += load(connections_);
+    totals.rejected_connections += load(rejected_connections_);
+    totals.bytes_in += load(bytes_in_);
+    totals.bytes_out += load(bytes_out_);
+}
@@ -0,0 +1,113 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Telemetry of one server thread, written only by that thread. A counter is
+// bumped with a relaxed load and store, plain moves with no locked instruction,
+// and no other thread writes its cache lines, so recording never contends. A
+// scrape reads every thread's shard with relaxed loads and merges them with add_to().
+class alignas(64) Metrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Latency histogram: upper bounds in ns and their Prometheus `le` labels.
+    static constexpr std::array<std::int64_t, 16> bucket_bounds = {
+        25'000, 50'000, 100'000, 250'000, 500'000, 1'000'000, 2'500'000, 5'000'000,
+        10'000'000, 25'000'000, 50'000'000, 100'000'000, 250'000'000, 500'000'000, 1'000'000'000, 2'500'000'000,
+    };
+    static constexpr std::array<std::string_view, 16> bucket_labels = {
+        "0.000025", "0.00005", "0.0001", "0.00025", "0.0005", "0.001", "0.0025", "0.005",
+        "0.01", "0.025", "0.05", "0.1", "0.25", "0.5", "1", "2.5",
+    };
+
+    // Statuses counted one by one; anything else is counted as "other".
+    static constexpr std::array<int, 12> statuses = {200, 206, 304, 400, 404, 405, 413, 416, 431, 500, 501, 503};
+
+    struct Route_Totals {
+        std::array<std::uint64_t, statuses.size() + 1> requests{};          // last: other statuses
+        std::array<std::uint64_t, bucket_bounds.size() + 1> buckets{};      // not cumulative, last: over every bound
+        std::uint64_t latency_ns = 0;
+    };
+
+    struct Totals {
+        std::vector<Route_Totals> routes;
+        std::uint64_t in_flight = 0;
+        std::uint64_t connections = 0;
+        std::uint64_t rejected_connections = 0;
+        std::uint64_t bytes_in = 0;
+        std::uint64_t bytes_out = 0;
+    };
+
+    // One row per route and one more, `routes`, for requests no route answered.
+    explicit Metrics(std::size_t routes);
+
+    // A parsed request, in flight until end_request() records its answer once
+    // sent, or abandon_requests() if the connection is gone before.
+    void begin_request() {
+        add(in_flight_, 1);
+    }
+
+    void end_request(std::size_t route, int status, Clock::duration latency);
+
+    void abandon_requests(std::size_t count) {
+        add(in_flight_, -count);
+    }
+
+    void open_connection() {
+        add(connections_, 1);
+    }
+
+    void close_connection() {
+        add(connections_, -1);
+    }
+
+    void reject_connection() {
+        add(rejected_connections_, 1);
+    }
+
+    void add_bytes(std::size_t in, std::size_t out) {
+        add(bytes_in_, in);
+        add(bytes_out_, out);
+    }
+
+    std::uint64_t connections() const {
+        return connections_.load(std::memory_order_relaxed);
+    }
+
+    // Adds this shard to totals, whose routes must have the same rows.
+    void add_to(Totals& totals) const;
+
+    std::size_t rows() const {
+        return routes_.size();
+    }
+
+private:
+    using Counter = std::atomic<std::uint64_t>;
+
+    // Single writer: no read-modify-write needed. Unsigned wrap-around makes a negative n a decrement.
+    static void add(Counter& counter, std::uint64_t n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    struct Route_Counters {
+        std::array<Counter, statuses.size() + 1> requests{};
+        std::array<Counter, bucket_bounds.size() + 1> buckets{};
+        Counter latency_ns{0};
+    };
+
+    std::vector<Route_Counters> routes_;
+    Counter in_flight_{0};
+    Counter connections_{0};
+    Counter rejected_connections_{0};
+    Counter bytes_in_{0};
+    Counter bytes_out_{0};
+};
@@ -0,0 +1,82 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Response_Batch.h"
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+#include <sys/sendfile.h>
+
+void Response_Batch::add_file(const File_Body& file) {
+    if (file.length == 0) return;
+    owners_.push_back(file.owner);
+    if (file.mapped) {
+        pieces_.push_back({file.mapped + file.offset, 0, file.length, static_piece});
+    } else {
+        pieces_.push_back({nullptr, file.offset, file.length, file_piece, file.fd});
+    }
+    size_ += file.length;
+}
+
+const char* Response_Batch::piece_data(const Piece& piece) const {
+    if (piece.owner == static_piece) return piece.data;
+    if (piece.owner == storage_piece) return storage_.data() + piece.offset;
+    return bodies_[piece.owner].data();
+}
+
+void Response_Batch::advance(std::size_t sent) {
+    sent_bytes_ += sent;
+    while (sent > 0) {
+        std::size_t left = pieces_[cursor_].size - cursor_offset_;
+        if (sent < left) {
+            cursor_offset_ += sent;
+            return;
+        }
+        sent -= left;
+        ++cursor_;
+        cursor_offset_ = 0;
+    }
+}
+
+bool Response_Batch::send(boost::asio::ip::tcp::socket& socket) {
+    while (cursor_ < pieces_.size()) {
+        const Piece& piece = pieces_[cursor_];
+
+        if (piece.owner == file_piece) {
+            auto offset = static_cast<off_t>(piece.offset + cursor_offset_);
+            ssize_t sent = ::sendfile(socket.native_handle(), piece.fd, &offset, piece.size - cursor_offset_);
+            if (sent < 0) {
+                if (errno == EAGAIN) return false;
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "sendfile");
+            }
+            if (sent == 0) throw std::runtime_error("sendfile: file shrank while being sent");
+            advance(static_cast<std::size_t>(sent));
+            continue;
+        }
+
+        buffers_.clear();
+        for (std::size_t i = cursor_; i < pieces_.size() && pieces_[i].owner != file_piece && buffers_.size() < max_iov; ++i) {
+            std::size_t skip = i == cursor_ ? cursor_offset_ : 0;
+            buffers_.emplace_back(piece_data(pieces_[i]) + skip, pieces_[i].size - skip);
+        }
+
+        boost::system::error_code ec;
+        std::size_t sent = socket.write_some(buffers_, ec);
+        if (ec == boost::asio::error::would_block) return false;
+        if (ec) throw boost::system::system_error(ec);
+        advance(sent);
+    }
+    return true;
+}
+
+void Response_Batch::clear() {
+    pieces_.clear();
+    storage_.clear();
+    bodies_.clear();
+    owners_.clear();
+    size_ = 0;
+    cursor_ = 0;
+    cursor_offset_ = 0;
+}
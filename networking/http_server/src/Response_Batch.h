@@ -0,0 +1,118 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <charconv>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+// A body served straight from a file: from its mapping if it has one, with sendfile otherwise.
+struct File_Body {
+    std::shared_ptr<const void> owner;          // keeps the mapping and descriptor alive until sent
+    const char* mapped = nullptr;
+    int fd = -1;
+    std::size_t offset = 0;
+    std::size_t length = 0;
+};
+
+// Responses of one pipelined batch as a list of pieces. Bytes that outlive the
+// write (literals, pre-serialized responses, mapped files) are referenced, small
+// dynamic parts are copied into one storage string, large bodies are moved in
+// (the arena holding them is reset only once the batch is sent),
+// unmapped files are sent with sendfile. Pieces keep offsets, not pointers, so
+// storage may grow; clear() keeps every capacity, so a warmed-up connection does not allocate.
+class Response_Batch {
+public:
+    void add_static(std::string_view bytes) {
+        if (bytes.empty()) return;
+        pieces_.push_back({bytes.data(), 0, bytes.size(), static_piece});
+        size_ += bytes.size();
+    }
+
+    void add_copy(std::string_view bytes) {
+        if (bytes.empty()) return;
+        if (!pieces_.empty() && pieces_.back().owner == storage_piece &&
+            pieces_.back().offset + pieces_.back().size == storage_.size()) {
+            pieces_.back().size += bytes.size();
+        } else {
+            pieces_.push_back({nullptr, storage_.size(), bytes.size(), storage_piece});
+        }
+        storage_ += bytes;
+        size_ += bytes.size();
+    }
+
+    void add_number(std::size_t value) {
+        char digits[20];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        add_copy({digits, static_cast<std::size_t>(result.ptr - digits)});
+    }
+
+    // Bodies up to copy_threshold are cheaper to copy than to give their own iovec.
+    void add_owned(std::pmr::string&& bytes) {
+        if (bytes.size() <= copy_threshold) {
+            add_copy(bytes);
+            return;
+        }
+        size_ += bytes.size();
+        pieces_.push_back({nullptr, 0, bytes.size(), static_cast<int>(bodies_.size())});
+        bodies_.push_back(std::move(bytes));
+    }
+
+    void add_file(const File_Body& file);
+
+    // Sends from where the last call stopped; false when the socket's buffer is
+    // full (wait for writability, then call again), true once everything is out.
+    // Runs of memory pieces go out with one writev, file pieces with sendfile.
+    bool send(boost::asio::ip::tcp::socket& socket);
+
+    std::size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    void clear();
+
+    // Bytes written to the socket since the last call, across clear()s.
+    std::size_t take_sent_bytes() {
+        return std::exchange(sent_bytes_, 0);
+    }
+
+private:
+    static constexpr int static_piece = -1;
+    static constexpr int storage_piece = -2;
+    static constexpr int file_piece = -3;
+    static constexpr std::size_t copy_threshold = 512;
+    static constexpr std::size_t max_iov = 64;
+
+    struct Piece {
+        const char* data;                       // static pieces only
+        std::size_t offset;                     // into storage_, or into the file
+        std::size_t size;
+        int owner;                              // static_piece, storage_piece, file_piece or index into bodies_
+        int fd = -1;                            // file pieces only
+    };
+
+    const char* piece_data(const Piece& piece) const;
+    void advance(std::size_t sent);
+
+    std::vector<Piece> pieces_;
+    std::string storage_;
+    std::vector<std::pmr::string> bodies_;
+    std::vector<std::shared_ptr<const void>> owners_;
+    std::vector<boost::asio::const_buffer> buffers_;
+    std::size_t size_ = 0;
+    std::size_t cursor_ = 0;                    // first piece not completely sent
+    std::size_t cursor_offset_ = 0;             // bytes of it already sent
+    std::size_t sent_bytes_ = 0;
+};
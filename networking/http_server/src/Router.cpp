@@ -0,0 +1,260 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Router.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+struct Router::Build_Node {
+    Build_Node() {
+        handlers.fill(-1);
+    }
+
+    std::map<std::string, std::unique_ptr<Build_Node>, std::less<>> literals;   // sorted, as compile() needs
+    std::unique_ptr<Build_Node> param;
+    std::string param_name;
+    std::unique_ptr<Build_Node> wildcard;
+    std::string wildcard_name;
+    std::array<std::int32_t, static_cast<std::size_t>(Http_Method::Count)> handlers;
+};
+
+namespace {
+    constexpr std::array<std::string_view, static_cast<std::size_t>(Http_Method::Count)> method_names = {
+        "GET", "HEAD", "POST", "PUT", "DELETE", "PATCH", "OPTIONS",
+    };
+
+    // Splits off the first segment of a path without its leading '/'.
+    std::string_view next_segment(std::string_view& rest) {
+        std::size_t slash = rest.find('/');
+        std::string_view segment = rest.substr(0, slash);
+        rest = slash == std::string_view::npos ? std::string_view() : rest.substr(slash + 1);
+        return segment;
+    }
+
+    std::string_view strip_leading_slashes(std::string_view path) {
+        while (!path.empty() && path.front() == '/') path.remove_prefix(1);
+        return path;
+    }
+
+    // Literal edges are searched linearly up to this many, binary search above.
+    constexpr std::uint32_t linear_edge_limit = 8;
+}
+
+Http_Method parse_method(std::string_view method) {
+    for (std::size_t i = 0; i < method_names.size(); ++i) {
+        if (method_names[i] == method) return static_cast<Http_Method>(i);
+    }
+    return Http_Method::Count;
+}
+
+std::string_view Route_Params::get(std::string_view name) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        if (names[i] == name) return values[i];
+    }
+    return {};
+}
+
+Router::Router(): root_(std::make_unique<Build_Node>()) {}
+Router::~Router() = default;
+Router::Router(Router&&) noexcept = default;
+Router& Router::operator=(Router&&) noexcept = default;
+
+void Router::add(Http_Method method, std::string_view pattern, Route_Handler handler) {
+    if (!root_) throw std::logic_error("Router: add() after compile()");
+
+    Build_Node* node = root_.get();
+    std::string_view rest = strip_leading_slashes(pattern);
+
+    while (!rest.empty()) {
+        std::string_view segment = next_segment(rest);
+        if (segment.empty()) continue;
+
+        if (segment.size() > 3 && segment.starts_with("{*") && segment.ends_with('}')) {
+            if (!rest.empty()) throw std::invalid_argument("Router: {*name} must be last in " + std::string(pattern));
+            if (!node->wildcard) {
+                node->wildcard = std::make_unique<Build_Node>();
+                node->wildcard_name = segment.substr(2, segment.size() - 3);
+            }
+            node = node->wildcard.get();
+        } else if (segment.size() > 2 && segment.front() == '{' && segment.back() == '}') {
+            std::string_view name = segment.substr(1, segment.size() - 2);
+            if (!node->param) {
+                node->param = std::make_unique<Build_Node>();
+                node->param_name = name;
+            } else if (node->param_name != name) {
+                throw std::invalid_argument("Router: conflicting parameter names in " + std::string(pattern));
+            }
+            node = node->param.get();
+        } else {
+            auto it = node->literals.find(segment);
+            if (it == node->literals.end()) {
+                it = node->literals.emplace(std::string(segment), std::make_unique<Build_Node>()).first;
+            }
+            node = it->second.get();
+        }
+    }
+
+    auto& slot = node->handlers[static_cast<std::size_t>(method)];
+    if (slot >= 0) throw std::invalid_argument("Router: duplicate route " + std::string(pattern));
+    slot = static_cast<std::int32_t>(handlers_.size());
+    handlers_.push_back(std::move(handler));
+    body_handlers_.emplace_back();
+    routes_.push_back({method, std::string(pattern)});
+}
+
+void Router::add_streaming(Http_Method method, std::string_view pattern, Body_Handler handler) {
+    add(method, pattern, [handler](const Http_Request& request, const Route_Params& params) {
+        Body_Reader reader = handler(request, params);
+        if (!request.body.empty()) reader.on_data(request.body);
+        return reader.finish();
+    });
+    body_handlers_.back() = std::move(handler);
+}
+
+void Router::compile() {
+    if (!root_) return;
+    nodes_.clear();
+    edges_.clear();
+    segments_.clear();
+    flatten(*root_);
+    root_.reset();
+}
+
+Router::Text Router::intern(std::string_view s) {
+    Text t{static_cast<std::uint32_t>(segments_.size()), static_cast<std::uint32_t>(s.size())};
+    segments_ += s;
+    return t;
+}
+
+std::string_view Router::text(Text t) const {
+    return std::string_view(segments_).substr(t.begin, t.size);
+}
+
+// Children of a node are flattened after it; its literal edges are reserved
+// up front so they stay contiguous, in the sorted order of the build map.
+std::uint32_t Router::flatten(const Build_Node& build) {
+    auto index = static_cast<std::uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+
+    Node node;
+    node.handlers = build.handlers;
+    for (std::size_t m = 0; m < build.handlers.size(); ++m) {
+        if (build.handlers[m] >= 0) node.allowed_methods |= static_cast<std::uint8_t>(1u << m);
+    }
+
+    node.first_edge = static_cast<std::uint32_t>(edges_.size());
+    node.edge_count = static_cast<std::uint32_t>(build.literals.size());
+    edges_.resize(edges_.size() + build.literals.size());
+
+    std::uint32_t edge = node.first_edge;
+    for (const auto& [segment, child] : build.literals) {
+        Text segment_text = intern(segment);
+        std::uint32_t child_index = flatten(*child);
+        edges_[edge++] = {segment_text, child_index};
+    }
+    if (build.param) {
+        node.param_name = intern(build.param_name);
+        node.param_child = static_cast<std::int32_t>(flatten(*build.param));
+    }
+    if (build.wildcard) {
+        node.wildcard_name = intern(build.wildcard_name);
+        node.wildcard_child = static_cast<std::int32_t>(flatten(*build.wildcard));
+    }
+
+    nodes_[index] = node;
+    return index;
+}
+
+Route_Match Router::match(Http_Method method, std::string_view path) const {
+    // An unknown method still walks the trie, so it gets a 405 on a known path.
+    Route_Match match;
+    if (!nodes_.empty()) match_node(0, method, strip_leading_slashes(path), match);
+    return match;
+}
+
+const Router::Edge* Router::find_edge(const Node& node, std::string_view segment) const {
+    const Edge* first = edges_.data() + node.first_edge;
+    const Edge* last = first + node.edge_count;
+
+    if (node.edge_count <= linear_edge_limit) {
+        for (const Edge* e = first; e != last; ++e) {
+            if (e->segment.size == segment.size() && text(e->segment) == segment) return e;
+        }
+        return nullptr;
+    }
+
+    const Edge* e = std::lower_bound(first, last, segment, [this](const Edge& edge, std::string_view s) {
+        return text(edge.segment) < s;
+    });
+    return e != last && text(e->segment) == segment ? e : nullptr;
+}
+
+// The path ends at this node: remember which methods exist for a 405, succeed
+// only if the requested one does. HEAD without a route of its own takes GET's.
+bool Router::match_end(const Node& node, Http_Method method, Route_Match& match) const {
+    if (node.allowed_methods == 0) return false;
+    match.path_found = true;
+    match.allowed_methods |= node.allowed_methods;
+
+    if (method == Http_Method::Count) return false;
+    std::int32_t handler = node.handlers[static_cast<std::size_t>(method)];
+    if (handler < 0 && method == Http_Method::Head) handler = node.handlers[static_cast<std::size_t>(Http_Method::Get)];
+    if (handler < 0) return false;
+    match.handler = &handlers_[handler];
+    match.route = static_cast<std::uint32_t>(handler);
+    if (body_handlers_[handler]) match.body_handler = &body_handlers_[handler];
+    return true;
+}
+
+bool Router::match_node(std::uint32_t index, Http_Method method, std::string_view rest, Route_Match& match) const {
+    const Node& node = nodes_[index];
+    std::size_t saved_count = match.params.count;
+
+    if (rest.empty()) {
+        if (match_end(node, method, match)) return true;
+    } else {
+        std::string_view remainder = rest;
+        std::string_view segment = next_segment(remainder);
+
+        if (const Edge* edge = find_edge(node, segment); edge && match_node(edge->child, method, remainder, match)) {
+            return true;
+        }
+
+        if (node.param_child >= 0 && !segment.empty() && match.params.count < Route_Params::max_params) {
+            match.params.names[match.params.count] = text(node.param_name);
+            match.params.values[match.params.count] = segment;
+            ++match.params.count;
+            if (match_node(static_cast<std::uint32_t>(node.param_child), method, remainder, match)) return true;
+            match.params.count = saved_count;
+        }
+    }
+
+    // {*name} takes whatever is left, including nothing.
+    if (node.wildcard_child >= 0 && match.params.count < Route_Params::max_params) {
+        match.params.names[match.params.count] = text(node.wildcard_name);
+        match.params.values[match.params.count] = rest;
+        ++match.params.count;
+        if (match_end(nodes_[node.wildcard_child], method, match)) return true;
+        match.params.count = saved_count;
+    }
+    return false;
+}
+
+std::string_view Router::method_name(Http_Method method) {
+    return method == Http_Method::Count ? std::string_view() : method_names[static_cast<std::size_t>(method)];
+}
+
+std::string Router::allow_header(std::uint8_t allowed_methods) {
+    if (allowed_methods & (1u << static_cast<std::size_t>(Http_Method::Get))) {
+        allowed_methods |= 1u << static_cast<std::size_t>(Http_Method::Head);
+    }
+    std::string allow;
+    for (std::size_t m = 0; m < method_names.size(); ++m) {
+        if (!(allowed_methods & (1u << m))) continue;
+        if (!allow.empty()) allow += ", ";
+        allow += method_names[m];
+    }
+    return allow;
+}
@@ -0,0 +1,141 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Http_Parser.h"
+#include "Http_Response.h"
+
+enum class Http_Method : std::uint8_t { Get, Head, Post, Put, Delete, Patch, Options, Count };
+
+// Count for anything the router does not know.
+Http_Method parse_method(std::string_view method);
+
+// Captured {name} segments; views into the router (names) and the request path (values).
+struct Route_Params {
+    static constexpr std::size_t max_params = 8;
+
+    std::array<std::string_view, max_params> names;
+    std::array<std::string_view, max_params> values;
+    std::size_t count = 0;
+
+    std::string_view get(std::string_view name) const;
+};
+
+using Route_Handler = std::function<Http_Response(const Http_Request&, const Route_Params&)>;
+
+// A request body handed over as it arrives: on_data() gets every decoded piece
+// (a view valid only during the call), finish() answers once the body is
+// complete. Either may throw to give up on the request (500, connection closed).
+struct Body_Reader {
+    std::function<void(std::string_view)> on_data;
+    std::function<Http_Response()> finish;
+};
+
+// Called with the head only; the request's views stay valid until finish() returns.
+using Body_Handler = std::function<Body_Reader(const Http_Request&, const Route_Params&)>;
+
+struct Route_Match {
+    const Route_Handler* handler = nullptr;     // null: 404 or 405
+    const Body_Handler* body_handler = nullptr; // set: the route takes its body as it arrives
+    bool path_found = false;                    // path matched but not the method -> 405
+    std::uint8_t allowed_methods = 0;           // bit per Http_Method, for the Allow header
+    std::uint32_t route = 0;                    // with a handler: its index, below route_count()
+    Route_Params params;
+};
+
+// Routes are added as patterns of '/'-separated segments: literal, {name}
+// (one segment) or {*name} (the rest of the path, last segment only).
+// compile() turns them into a segment trie stored in flat arrays: one node per
+// distinct prefix, literal edges of a node contiguous and sorted, so matching
+// walks the path once, compares only segments of the same length and never
+// allocates. Literal edges win over {name}, backtracking if they dead-end.
+class Router {
+public:
+    Router();
+    ~Router();
+    Router(Router&&) noexcept;
+    Router& operator=(Router&&) noexcept;
+
+    void add(Http_Method method, std::string_view pattern, Route_Handler handler);
+
+    // A route that reads its body as it arrives; a body received along with
+    // the head is passed in one piece through the same reader.
+    void add_streaming(Http_Method method, std::string_view pattern, Body_Handler handler);
+    void compile();
+
+    // Path without the query string; valid only after compile().
+    Route_Match match(Http_Method method, std::string_view path) const;
+
+    std::size_t route_count() const {
+        return handlers_.size();
+    }
+
+    // What a route (Route_Match::route) was added with.
+    Http_Method route_method(std::size_t route) const {
+        return routes_[route].method;
+    }
+
+    std::string_view route_pattern(std::size_t route) const {
+        return routes_[route].pattern;
+    }
+
+    static std::string_view method_name(Http_Method method);
+
+    // HEAD is listed wherever GET is, as the GET route answers it.
+    static std::string allow_header(std::uint8_t allowed_methods);
+
+private:
+    struct Build_Node;
+
+    struct Route {
+        Http_Method method;
+        std::string pattern;
+    };
+
+    // Strings are kept as offsets into segments_, so moving the router keeps them valid.
+    struct Text {
+        std::uint32_t begin = 0;
+        std::uint32_t size = 0;
+    };
+
+    struct Edge {
+        Text segment;
+        std::uint32_t child;
+    };
+
+    struct Node {
+        std::uint32_t first_edge = 0;
+        std::uint32_t edge_count = 0;
+        std::int32_t param_child = -1;
+        std::int32_t wildcard_child = -1;
+        Text param_name;
+        Text wildcard_name;
+        std::uint8_t allowed_methods = 0;
+        std::array<std::int32_t, static_cast<std::size_t>(Http_Method::Count)> handlers;
+    };
+
+    std::uint32_t flatten(const Build_Node& node);
+    Text intern(std::string_view text);
+    std::string_view text(Text t) const;
+    const Edge* find_edge(const Node& node, std::string_view segment) const;
+    bool match_node(std::uint32_t node, Http_Method method, std::string_view rest, Route_Match& match) const;
+    bool match_end(const Node& node, Http_Method method, Route_Match& match) const;
+
+private:
+    std::unique_ptr<Build_Node> root_;          // released by compile()
+    std::vector<Node> nodes_;
+    std::vector<Edge> edges_;
+    std::string segments_;                      // literal segments and parameter names, back to back
+    std::vector<Route_Handler> handlers_;
+    std::vector<Body_Handler> body_handlers_;   // parallel to handlers_, empty for non-streaming routes
+    std::vector<Route> routes_;                 // parallel to handlers_
+};
@@ -0,0 +1,390 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Static_Files.h"
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <ctime>
+#include <stdexcept>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Extension_Type {
+        std::string_view extension;
+        std::string_view type;
+    };
+
+    constexpr Extension_Type content_types[] = {
+        {"html", "text/html; charset=utf-8"},
+        {"htm", "text/html; charset=utf-8"},
+        {"css", "text/css; charset=utf-8"},
+        {"js", "text/javascript; charset=utf-8"},
+        {"mjs", "text/javascript; charset=utf-8"},
+        {"json", "application/json"},
+        {"txt", "text/plain; charset=utf-8"},
+        {"xml", "application/xml"},
+        {"svg", "image/svg+xml"},
+        {"png", "image/png"},
+        {"jpg", "image/jpeg"},
+        {"jpeg", "image/jpeg"},
+        {"gif", "image/gif"},
+        {"webp", "image/webp"},
+        {"ico", "image/x-icon"},
+        {"woff", "font/woff"},
+        {"woff2", "font/woff2"},
+        {"wasm", "application/wasm"},
+        {"pdf", "application/pdf"},
+    };
+
+    std::string_view content_type(std::string_view path) {
+        std::size_t dot = path.rfind('.');
+        if (dot != std::string_view::npos && path.find('/', dot) == std::string_view::npos) {
+            std::string_view extension = path.substr(dot + 1);
+            for (const auto& entry : content_types) {
+                if (iequals(entry.extension, extension)) return entry.type;
+            }
+        }
+        return "application/octet-stream";
+    }
+
+    std::string http_date(std::time_t seconds) {
+        std::tm time{};
+        gmtime_r(&seconds, &time);
+        char line[32];
+        std::size_t size = std::strftime(line, sizeof(line), "%a, %d %b %Y %H:%M:%S GMT", &time);
+        return {line, size};
+    }
+
+    // -1 if the value is not an IMF-fixdate.
+    std::time_t parse_http_date(std::string_view value) {
+        char text[64];
+        if (value.size() >= sizeof(text)) return -1;
+        value.copy(text, value.size());
+        text[value.size()] = '\0';
+
+        std::tm time{};
+        const char* end = strptime(text, "%a, %d %b %Y %H:%M:%S GMT", &time);
+        if (!end || *end != '\0') return -1;
+        return timegm(&time);
+    }
+
+    int hex_value(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    // Percent-decodes the URL path into out; false for anything that could
+    // leave the root: empty, NUL, "." or ".." segments.
+    bool decode_path(std::string_view path, std::string& out) {
+        out.clear();
+        for (std::size_t i = 0; i < path.size(); ++i) {
+            char c = path[i];
+            if (c == '%') {
+                if (i + 2 >= path.size()) return false;
+                int high = hex_value(path[i + 1]);
+                int low = hex_value(path[i + 2]);
+                if (high < 0 || low < 0) return false;
+                c = static_cast<char>(high * 16 + low);
+                i += 2;
+            }
+            if (c == '\0') return false;
+            out += c;
+        }
+
+        std::string_view rest = out;
+        while (!rest.empty() && rest.front() == '/') rest.remove_prefix(1);
+        if (rest.empty()) return false;
+        out.erase(0, out.size() - rest.size());
+
+        for (std::size_t begin = 0; begin <= out.size();) {
+            std::size_t end = std::min(out.find('/', begin), out.size());
+            std::string_view segment(out.data() + begin, end - begin);
+            if (segment == "." || segment == "..") return false;
+            begin = end + 1;
+        }
+        return true;
+    }
+
+    // Any of the listed entity tags (or *) matches; weak comparison, as If-None-Match uses.
+    bool etag_matches(std::string_view list, std::string_view etag) {
+        if (list == "*") return true;
+        while (!list.empty()) {
+            std::size_t comma = list.find(',');
+            std::string_view tag = list.substr(0, comma);
+            list = comma == std::string_view::npos ? std::string_view() : list.substr(comma + 1);
+
+            while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t')) tag.remove_prefix(1);
+            while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t')) tag.remove_suffix(1);
+            if (tag.starts_with("W/")) tag.remove_prefix(2);
+            if (tag == etag) return true;
+        }
+        return false;
+    }
+
+    bool parse_number(std::string_view text, std::size_t& value) {
+        if (text.empty()) return false;
+        auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ec == std::errc() && end == text.data() + text.size();
+    }
+
+    enum class Range_Status { None, Valid, Unsatisfiable };
+
+    // A single "bytes=first-last", "bytes=first-" or "bytes=-suffix" range.
+    // Anything else, multiple ranges included, is ignored and the whole file is sent.
+    Range_Status parse_range(std::string_view value, std::size_t size, std::size_t& first, std::size_t& last) {
+        if (!value.starts_with("bytes=")) return Range_Status::None;
+        value.remove_prefix(6);
+        if (value.find(',') != std::string_view::npos) return Range_Status::None;
+
+        std::size_t dash = value.find('-');
+        if (dash == std::string_view::npos) return Range_Status::None;
+        std::string_view first_text = value.substr(0, dash);
+        std::string_view last_text = value.substr(dash + 1);
+
+        if (first_text.empty()) {
+            std::size_t suffix = 0;
+            if (!parse_number(last_text, suffix)) return Range_Status::None;
+            if (suffix == 0 || size == 0) return Range_Status::Unsatisfiable;
+            first = size - std::min(suffix, size);
+            last = size - 1;
+            return Range_Status::Valid;
+        }
+
+        if (!parse_number(first_text, first)) return Range_Status::None;
+        if (last_text.empty()) {
+            last = size - 1;
+        } else if (!parse_number(last_text, last) || last < first) {
+            return Range_Status::None;
+        }
+        if (first >= size) return Range_Status::Unsatisfiable;
+        last = std::min(last, size - 1);
+        return Range_Status::Valid;
+    }
+
+    // Streams an unmapped file through the encoder in pieces, so only the
+    // compressed form is ever held in memory.
+    std::string gzip_file(const Static_File& file, int level) {
+        constexpr std::size_t piece = 256 * 1024;
+
+        std::string out;
+        out.reserve(file.size / 4 + 64);
+        Gzip_Encoder encoder(level);
+        if (file.mapped) {
+            encoder.write({file.mapped, file.size}, out);
+        } else {
+            std::vector<char> buffer(std::min(piece, file.size));
+            for (std::size_t offset = 0; offset < file.size;) {
+                ssize_t size = pread(file.fd, buffer.data(), std::min(piece, file.size - offset), static_cast<off_t>(offset));
+                if (size < 0 && errno == EINTR) continue;
+                if (size <= 0) throw std::runtime_error("pread failed while compressing a static file");
+                encoder.write({buffer.data(), static_cast<std::size_t>(size)}, out);
+                offset += static_cast<std::size_t>(size);
+            }
+        }
+        encoder.finish(out);
+        return out;
+    }
+
+    bool same_file(const Static_File& file, const struct stat& st) {
+        return file.inode == st.st_ino && file.size == static_cast<std::size_t>(st.st_size) &&
+               file.mtime_ns == st.st_mtim.tv_sec * 1'000'000'000LL + st.st_mtim.tv_nsec;
+    }
+}
+
+Static_File::~Static_File() {
+    if (mapped) munmap(const_cast<char*>(mapped), size);
+    if (fd >= 0) close(fd);
+}
+
+Static_Files::Static_Files(std::string root, const Static_Files_Options& options, const Compression_Options& compression)
+    : root_(std::move(root)), options_(options), compression_(compression)
+{
+    while (root_.size() > 1 && root_.back() == '/') root_.pop_back();
+}
+
+Http_Response Static_Files::serve(const Http_Request& request, std::string_view path, bool head_only) {
+    thread_local std::string relative;
+    File_Ptr file = decode_path(path, relative) ? open(relative) : nullptr;
+    if (!file) return {404, "Not Found"};
+
+    // Range requests address bytes of the file itself, so they always get it unencoded.
+    bool use_gzip = file->compressible && request.header("Range").empty() &&
+                    accepts_gzip(request.header("Accept-Encoding"));
+    if (use_gzip) compress(file, relative);
+    const std::string& etag = use_gzip ? file->gzip_etag : file->etag;
+
+    Http_Response response(200, {}, {}, request.arena);
+    response.extra_headers = use_gzip ? file->gzip_headers : file->headers;
+    response.head_only = head_only;
+
+    std::string_view if_none_match = request.header("If-None-Match");
+    if (!if_none_match.empty()) {
+        if (etag_matches(if_none_match, etag)) {
+            response.status = 304;
+            return response;
+        }
+    } else if (std::string_view since = request.header("If-Modified-Since"); !since.empty()) {
+        std::time_t time = parse_http_date(since);
+        if (time >= 0 && file->mtime_ns / 1'000'000'000LL <= time) {
+            response.status = 304;
+            return response;
+        }
+    }
+
+    if (use_gzip) {
+        response.file = {file, file->gzip.data(), -1, 0, file->gzip.size()};
+        return response;
+    }
+
+    std::size_t first = 0;
+    std::size_t last = file->size == 0 ? 0 : file->size - 1;
+    std::string_view range = request.header("Range");
+    std::string_view if_range = request.header("If-Range");
+    Range_Status range_status = Range_Status::None;
+    if (!range.empty() && (if_range.empty() || if_range == file->etag)) {
+        range_status = parse_range(range, file->size, first, last);
+    }
+
+    if (range_status == Range_Status::Unsatisfiable) {
+        response = {416, {}, {}};
+        response.extra_headers.append("Content-Range: bytes */").append(std::to_string(file->size)).append("\r\n");
+        return response;
+    }
+
+    response.file = {file, file->mapped, file->fd, 0, file->size};
+    if (range_status == Range_Status::Valid) {
+        response.status = 206;
+        response.file.offset = first;
+        response.file.length = last - first + 1;
+        response.extra_headers.append("Content-Range: bytes ").append(std::to_string(first)).append("-")
+                              .append(std::to_string(last)).append("/").append(std::to_string(file->size)).append("\r\n");
+    }
+    return response;
+}
+
+// A cached file is trusted for options_.revalidate, then checked with stat()
+// and reopened if it changed. Opening and stat() happen outside the lock.
+Static_Files::File_Ptr Static_Files::open(std::string_view relative) {
+    File_Ptr cached;
+    {
+        std::lock_guard lock(mutex_);
+        auto it = index_.find(relative);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            if (Clock::now() - it->second->checked < options_.revalidate) return it->second->file;
+            cached = it->second->file;
+        }
+    }
+
+    std::string key(relative);
+    if (cached) {
+        struct stat st{};
+        if (stat((root_ + '/' + key).c_str(), &st) == 0 && same_file(*cached, st)) {
+            std::lock_guard lock(mutex_);
+            if (auto it = index_.find(key); it != index_.end() && it->second->file == cached) {
+                it->second->checked = Clock::now();
+            }
+            return cached;
+        }
+    }
+
+    File_Ptr file = open_file(key);
+
+    std::lock_guard lock(mutex_);
+    if (auto it = index_.find(key); it != index_.end()) {
+        cached_bytes_ -= it->second->cost;
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+    if (!file) return nullptr;
+
+    std::size_t cost = file->mapped ? file->size : 0;
+    lru_.push_front({key, file, Clock::now(), cost});
+    index_.emplace(std::move(key), lru_.begin());
+    cached_bytes_ += cost;
+    evict();
+    return file;
+}
+
+Static_Files::File_Ptr Static_Files::open_file(const std::string& relative) const {
+    int fd = ::open((root_ + '/' + relative).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return nullptr;
+
+    auto file = std::make_shared<Static_File>();
+    file->fd = fd;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return nullptr;
+
+    file->size = static_cast<std::size_t>(st.st_size);
+    file->mtime_ns = st.st_mtim.tv_sec * 1'000'000'000LL + st.st_mtim.tv_nsec;
+    file->inode = st.st_ino;
+
+    if (file->size > 0 && file->size <= options_.max_mapped_size) {
+        void* data = mmap(nullptr, file->size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) file->mapped = static_cast<const char*>(data);
+    }
+
+    char etag[48];
+    int etag_size = std::snprintf(etag, sizeof(etag), "\"%llx-%zx\"",
+                                  static_cast<unsigned long long>(st.st_mtim.tv_sec), file->size);
+    file->etag.assign(etag, static_cast<std::size_t>(etag_size));
+
+    std::string_view type = content_type(relative);
+    file->headers = "Content-Type: ";
+    file->headers += type;
+    file->headers += "\r\nETag: " + file->etag;
+    file->headers += "\r\nLast-Modified: " + http_date(st.st_mtim.tv_sec);
+    file->headers += "\r\nAccept-Ranges: bytes\r\n";
+
+    file->compressible = compression_.level > 0 && compressible(type) &&
+                         file->size >= compression_.min_size && file->size <= compression_.max_file_size;
+    if (file->compressible) {
+        file->headers += "Vary: Accept-Encoding\r\n";
+        file->gzip_etag = file->etag;
+        file->gzip_etag.insert(file->gzip_etag.size() - 1, "-gzip");
+        file->gzip_headers = "Content-Type: ";
+        file->gzip_headers += type;
+        file->gzip_headers += "\r\nContent-Encoding: gzip\r\nVary: Accept-Encoding\r\nETag: " + file->gzip_etag;
+        file->gzip_headers += "\r\nLast-Modified: " + http_date(st.st_mtim.tv_sec) + "\r\n";
+    }
+    return file;
+}
+
+// The first request that wants the gzip form compresses the file (on its own
+// thread; others wanting the same file wait for it), the LRU then counts it.
+void Static_Files::compress(const File_Ptr& file, std::string_view relative) {
+    bool compressed = false;
+    std::call_once(file->gzip_once, [&]() {
+        file->gzip = gzip_file(*file, compression_.level);
+        compressed = true;
+    });
+    if (!compressed) return;
+
+    std::lock_guard lock(mutex_);
+    if (auto it = index_.find(relative); it != index_.end() && it->second->file == file) {
+        it->second->cost += file->gzip.size();
+        cached_bytes_ += file->gzip.size();
+        evict();
+    }
+}
+
+// Least recently used first, until both the mapped bytes and the open descriptors fit.
+void Static_Files::evict() {
+    while (lru_.size() > 1 && (cached_bytes_ > options_.cache_bytes || lru_.size() > options_.max_entries)) {
+        const Entry& entry = lru_.back();
+        cached_bytes_ -= entry.cost;
+        index_.erase(entry.path);
+        lru_.pop_back();
+    }
+}
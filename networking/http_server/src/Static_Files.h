@@ -0,0 +1,95 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "Compression.h"
+#include "Http_Parser.h"
+#include "Http_Response.h"
+
+struct Static_Files_Options {
+    std::size_t cache_bytes = 64 * 1024 * 1024;     // mapped and gzip bytes kept by the LRU
+    std::size_t max_mapped_size = 1024 * 1024;      // larger files are sent with sendfile, not mapped
+    std::size_t max_entries = 1024;                 // open descriptors kept by the LRU
+    std::chrono::milliseconds revalidate{1000};     // a cached file is stat()ed again after this long
+};
+
+// An open file under the root, mapped if small, with its response headers
+// (Content-Type, ETag, Last-Modified, Accept-Ranges) serialized when opened.
+// A compressible file gets its gzip form on the first request that accepts it,
+// with its own ETag and headers.
+struct Static_File {
+    Static_File() = default;
+    Static_File(const Static_File&) = delete;
+    Static_File& operator=(const Static_File&) = delete;
+    ~Static_File();
+
+    int fd = -1;
+    const char* mapped = nullptr;
+    std::size_t size = 0;
+    std::int64_t mtime_ns = 0;
+    std::uint64_t inode = 0;
+    std::string etag;
+    std::string headers;
+
+    bool compressible = false;
+    std::string gzip_etag;
+    std::string gzip_headers;
+    mutable std::once_flag gzip_once;
+    mutable std::string gzip;                   // written once under gzip_once
+};
+
+// Serves files below a root directory. Hot files stay open in an LRU shared by
+// all server threads: small ones as read-only mappings sent with writev, large
+// ones as descriptors sent with sendfile, so file data is never copied through
+// user space. Answers If-None-Match / If-Modified-Since with 304 and a single
+// byte range with 206 (416 if unsatisfiable). Compressible files are sent
+// gzip-encoded to clients that accept it, compressed once per file version.
+class Static_Files {
+public:
+    explicit Static_Files(std::string root, const Static_Files_Options& options = {},
+                          const Compression_Options& compression = {});
+
+    // path: below the root, as in the URL (percent-encoded, no query string).
+    Http_Response serve(const Http_Request& request, std::string_view path, bool head_only);
+
+private:
+    using File_Ptr = std::shared_ptr<const Static_File>;
+
+    struct Entry {
+        std::string path;
+        File_Ptr file;
+        std::chrono::steady_clock::time_point checked;
+        std::size_t cost = 0;                   // mapped bytes plus the gzip form, once made
+    };
+
+    struct Path_Hash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view path) const {
+            return std::hash<std::string_view>{}(path);
+        }
+    };
+
+    File_Ptr open(std::string_view relative);
+    File_Ptr open_file(const std::string& relative) const;
+    void compress(const File_Ptr& file, std::string_view relative);
+    void evict();
+
+private:
+    std::string root_;
+    Static_Files_Options options_;
+    Compression_Options compression_;
+
+    std::mutex mutex_;
+    std::list<Entry> lru_;                      // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator, Path_Hash, std::equal_to<>> index_;
+    std::size_t cached_bytes_ = 0;
+};
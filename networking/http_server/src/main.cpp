@@ -0,0 +1,87 @@
+#include <boost/asio.hpp>
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include "Http_Server.h"
+
+Logger logger(Logger::Mode::Text, std::cout);
+
+// Sends all requests over one keep-alive connection in a single write (pipelined),
+// the last one asks the server to close, then reads until it does.
+std::string http_requests(const std::string& host, unsigned short port, const std::vector<std::string>& paths) {
+    boost::asio::io_context io;
+    tcp::socket socket(io);
+    socket.connect(tcp::endpoint(boost::asio::ip::make_address(host), port));
+
+    std::string requests;
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        requests += "GET " + paths[i] + " HTTP/1.1\r\nHost: " + host + "\r\n";
+        if (i + 1 == paths.size()) requests += "Connection: close\r\n";
+        requests += "\r\n";
+    }
+    boost::asio::write(socket, boost::asio::buffer(requests));
+
+    std::string responses;
+    boost::system::error_code ec;
+    boost::asio::read(socket, boost::asio::dynamic_buffer(responses), ec);
+
+    return responses;
+}
+
+int main(int argc, char* argv[]) {
+    Http_Options options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max(1ul, std::stoul(argv[++i]));
+        } else if (arg == "--idle-timeout" && i + 1 < argc) {
+            options.idle_timeout = std::chrono::milliseconds(std::stoul(argv[++i]));
+        } else if (arg == "--max-requests" && i + 1 < argc) {
+            options.max_requests_per_connection = std::max(1ul, std::stoul(argv[++i]));
+        } else if (arg == "--static" && i + 1 < argc) {
+            options.static_root = argv[++i];
+        } else if (arg == "--file-cache-mb" && i + 1 < argc) {
+            options.static_files.cache_bytes = std::stoul(argv[++i]) * 1024 * 1024;
+        } else if (arg == "--gzip-level" && i + 1 < argc) {
+            options.compression.level = std::clamp(std::stoi(argv[++i]), 0, 9);
+        } else if (arg == "--gzip-min-size" && i + 1 < argc) {
+            options.compression.min_size = std::stoul(argv[++i]);
+        } else if (arg == "--max-connections" && i + 1 < argc) {
+            options.admission.max_connections = std::stoul(argv[++i]);
+        } else if (arg == "--pause-accept") {
+            options.admission.pause_accept = true;
+        } else if (arg == "--max-in-flight" && i + 1 < argc) {
+            options.admission.max_in_flight = std::stoul(argv[++i]);
+        } else if (arg == "--max-queue-ms" && i + 1 < argc) {
+            options.admission.max_queue_time = std::chrono::milliseconds(std::stoul(argv[++i]));
+        } else if (arg == "--retry-after" && i + 1 < argc) {
+            options.admission.retry_after = std::chrono::seconds(std::stoul(argv[++i]));
+        } else if (arg == "--request-arena" && i + 1 < argc) {
+            options.request_arena_size = std::stoul(argv[++i]);
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--threads N] [--idle-timeout MS] [--max-requests N] [--static DIR] [--file-cache-mb N]\n"
+                      << "       [--gzip-level 0-9] [--gzip-min-size BYTES]\n"
+                      << "       [--max-connections N] [--pause-accept] [--max-in-flight N] [--max-queue-ms MS] [--retry-after S]\n"
+                      << "       [--request-arena BYTES]\n";
+            return 2;
+        }
+    }
+
+    logger.start();
+
+    Http_Server server(8080, options);
+
+    std::thread server_thread([&server]() { server.run(); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::cout << "--- /hello, /json, /users/42, /unknown on one connection ---\n"
+              << http_requests("127.0.0.1", 8080, {"/hello", "/json", "/users/42", "/unknown"}) << "\n";
+
+    server_thread.join();
+}
@@ -0,0 +1,344 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Load_Generator.h"
+#include <boost/asio.hpp>
+#include <sys/resource.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "Protocol.h"
+
+using boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+void Load_Stats::merge(const Load_Stats& other) {
+    latency.merge(other.latency);
+    requests += other.requests;
+    rejected += other.rejected;
+    late += other.late;
+    bytes_in += other.bytes_in;
+    bytes_out += other.bytes_out;
+    errors += other.errors;
+    reconnects += other.reconnects;
+}
+
+namespace {
+    // Read-only after start, shared by every connection.
+    struct Run_State {
+        const Load_Config& config;
+        const Protocol& protocol;
+        tcp::endpoint server;
+        std::atomic<bool> recording = false;
+        std::atomic<bool> stopping = false;
+        std::atomic<std::size_t> settled = 0;        // connections past their first connect attempt
+    };
+
+    constexpr auto retry_delay = std::chrono::milliseconds(100);
+
+    class Connection : public std::enable_shared_from_this<Connection> {
+    public:
+        Connection(boost::asio::io_context& io, Run_State& run, Load_Stats& stats, std::size_t index)
+            : run_(run), stats_(stats), index_(index), socket_(io), schedule_timer_(io), retry_timer_(io) {
+            if (run_.config.rate > 0) {
+                auto connections = static_cast<double>(run_.config.connections);
+                interval_ = std::chrono::duration<double>(connections / run_.config.rate);
+                offset_ = interval_ * (static_cast<double>(index_) / connections);
+            }
+        }
+
+        void start() {
+            connect();
+        }
+
+        // Open loop only: request k is due at start + offset + k * interval.
+        void start_schedule(Clock::time_point start) {
+            schedule_start_ = start;
+            schedule_next();
+        }
+
+    private:
+        bool open_loop() const {
+            return run_.config.rate > 0;
+        }
+
+        Clock::time_point due_time(std::uint64_t k) const {
+            auto offset = offset_ + interval_ * static_cast<double>(k);
+            return schedule_start_ + std::chrono::duration_cast<Clock::duration>(offset);
+        }
+
+        void connect() {
+            ++generation_;
+            ready_ = false;
+            in_flight_ = false;
+            in_.clear();
+
+            boost::system::error_code ec;
+            socket_.close(ec);
+            socket_.open(tcp::v4(), ec);
+            if (!ec && run_.config.local_addrs > 1) {
+                auto address = boost::asio::ip::make_address_v4(0x7f000001 + index_ % run_.config.local_addrs);
+                socket_.bind(tcp::endpoint(address, 0), ec);
+            }
+            if (ec) {
+                fail();
+                return;
+            }
+
+            socket_.async_connect(run_.server, [self = shared_from_this(), generation = generation_](boost::system::error_code ec) {
+                if (generation != self->generation_) return;
+                if (ec) {
+                    self->fail();
+                    return;
+                }
+                self->socket_.set_option(tcp::no_delay(true));
+                self->handshake();
+            });
+        }
+
+        void handshake() {
+            std::string request = run_.protocol.handshake();
+            if (request.empty()) {
+                on_ready();
+                read();
+                return;
+            }
+
+            out_ = std::move(request);
+            boost::asio::async_write(socket_, boost::asio::buffer(out_),
+                [self = shared_from_this(), generation = generation_](boost::system::error_code ec, std::size_t) {
+                    if (generation != self->generation_) return;
+                    if (ec) self->fail();
+                    else self->read();
+                });
+        }
+
+        void on_ready() {
+            ready_ = true;
+            if (!settled_) {
+                settled_ = true;
+                ++run_.settled;
+            }
+            if (!open_loop() || due_ > sent_) send();
+        }
+
+        // The connection always has a read pending once connected: websocket
+        // peers deliver broadcasts whether or not we are waiting for a reply.
+        void read() {
+            socket_.async_read_some(boost::asio::buffer(buffer_),
+                [self = shared_from_this(), generation = generation_](boost::system::error_code ec, std::size_t length) {
+                    if (generation != self->generation_) return;
+                    if (ec) {
+                        self->fail();
+                        return;
+                    }
+                    if (self->run_.recording) self->stats_.bytes_in += length;
+                    self->in_.append(self->buffer_.data(), length);
+                    if (self->process()) self->read();
+                });
+        }
+
+        // False if the connection was replaced.
+        bool process() {
+            try {
+                if (!ready_) {
+                    std::size_t consumed = run_.protocol.handshake_reply(in_);
+                    if (consumed == 0) return true;
+                    in_.erase(0, consumed);
+                    on_ready();
+                }
+
+                while (!in_.empty()) {
+                    Reply reply = run_.protocol.parse_reply(in_, in_flight_ ? request_id_ : ~0ull);
+                    if (reply.consumed == 0) break;
+                    in_.erase(0, reply.consumed);
+
+                    if (reply.matched && in_flight_) complete(reply.rejected);
+                    if (reply.close && reply.rejected) {
+                        // Turned away at accept: back off like a client honouring Retry-After.
+                        ++generation_;
+                        ready_ = false;
+                        retry_later();
+                        return false;
+                    }
+                    if (reply.close) {
+                        ++stats_.reconnects;
+                        connect();
+                        return false;
+                    }
+                }
+            } catch (std::exception&) {
+                fail();
+                return false;
+            }
+            return true;
+        }
+
+        void send() {
+            if (run_.stopping || in_flight_ || !ready_) return;
+
+            request_id_ = (std::uint64_t(index_) << 32) | std::uint32_t(sequence_++);
+            sent_at_ = open_loop() ? due_time(sent_) : Clock::now();
+            ++sent_;
+            in_flight_ = true;
+
+            out_.clear();
+            run_.protocol.make_request(out_, request_id_);
+            boost::asio::async_write(socket_, boost::asio::buffer(out_),
+                [self = shared_from_this(), generation = generation_](boost::system::error_code ec, std::size_t length) {
+                    if (generation != self->generation_) return;
+                    if (ec) {
+                        self->fail();
+                        return;
+                    }
+                    if (self->run_.recording) self->stats_.bytes_out += length;
+                });
+        }
+
+        // Rejections are counted, not timed: a fast 503 would make the latency of served requests look better.
+        void complete(bool rejected) {
+            in_flight_ = false;
+            if (run_.recording && rejected) {
+                ++stats_.rejected;
+            } else if (run_.recording) {
+                auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - sent_at_);
+                stats_.latency.record(static_cast<std::uint64_t>(std::max<std::int64_t>(latency.count(), 0)));
+                ++stats_.requests;
+                if (run_.config.deadline_ms > 0 && latency.count() > run_.config.deadline_ms * 1e6) ++stats_.late;
+            }
+            if (!open_loop() || due_ > sent_) send();
+        }
+
+        void schedule_next() {
+            schedule_timer_.expires_at(due_time(due_));
+            schedule_timer_.async_wait([self = shared_from_this()](boost::system::error_code ec) {
+                if (ec || self->run_.stopping) return;
+                ++self->due_;
+                self->send();
+                self->schedule_next();
+            });
+        }
+
+        // A request lost with the connection is not retried; open loop moves on
+        // to the next due request, closed loop sends a new one once reconnected.
+        void fail() {
+            ++generation_;
+            ready_ = false;
+            if (!settled_) {
+                settled_ = true;
+                ++run_.settled;
+            }
+            if (run_.stopping) return;
+
+            ++stats_.errors;
+            retry_later();
+        }
+
+        void retry_later() {
+            boost::system::error_code ec;
+            socket_.close(ec);
+
+            retry_timer_.expires_after(retry_delay);
+            retry_timer_.async_wait([self = shared_from_this()](boost::system::error_code ec) {
+                if (ec || self->run_.stopping) return;
+                ++self->stats_.reconnects;
+                self->connect();
+            });
+        }
+
+        Run_State& run_;
+        Load_Stats& stats_;
+        std::size_t index_;
+        tcp::socket socket_;
+        boost::asio::steady_timer schedule_timer_;
+        boost::asio::steady_timer retry_timer_;
+
+        std::array<char, 16 * 1024> buffer_;
+        std::string in_;
+        std::string out_;
+        std::uint64_t generation_ = 0;           // bumped on reconnect, stale handlers bail out
+        bool settled_ = false;
+        bool ready_ = false;
+        bool in_flight_ = false;
+        std::uint64_t request_id_ = 0;
+        std::uint64_t sequence_ = 0;
+        Clock::time_point sent_at_;
+
+        std::chrono::duration<double> interval_{0};
+        std::chrono::duration<double> offset_{0};
+        Clock::time_point schedule_start_;
+        std::uint64_t due_ = 0;                  // requests whose due time has passed
+        std::uint64_t sent_ = 0;                 // requests sent, in due order
+    };
+
+    void raise_fd_limit() {
+        rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+            setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+
+    void sleep_for(double seconds) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    }
+}
+
+Load_Generator::Load_Generator(const Load_Config& config)
+    : config_(config) {}
+
+Load_Stats Load_Generator::run() {
+    raise_fd_limit();
+
+    auto protocol = make_protocol(config_.protocol, config_.host, config_.path, config_.message_size, config_.headers);
+    Run_State run{config_, *protocol, tcp::endpoint(boost::asio::ip::make_address(config_.host), config_.port)};
+
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts;
+    std::vector<Load_Stats> stats(config_.threads);
+    for (std::size_t i = 0; i < config_.threads; ++i) {
+        contexts.push_back(std::make_unique<boost::asio::io_context>(1));
+    }
+
+    std::vector<std::shared_ptr<Connection>> connections;
+    for (std::size_t i = 0; i < config_.connections; ++i) {
+        std::size_t t = i % config_.threads;
+        connections.push_back(std::make_shared<Connection>(*contexts[t], run, stats[t], i));
+        connections.back()->start();
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& context : contexts) {
+        threads.emplace_back([&context]() { context->run(); });
+    }
+
+    while (run.settled < config_.connections) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    if (config_.rate > 0) {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < connections.size(); ++i) {
+            boost::asio::post(*contexts[i % config_.threads], [c = connections[i], start]() { c->start_schedule(start); });
+        }
+    }
+
+    sleep_for(config_.warmup_seconds);
+    run.recording = true;
+    auto started = Clock::now();
+    sleep_for(config_.seconds);
+    run.recording = false;
+    measured_seconds_ = std::chrono::duration<double>(Clock::now() - started).count();
+
+    // Stats are merged only once the event loops have stopped touching them.
+    run.stopping = true;
+    for (auto& context : contexts) context->stop();
+    for (auto& thread : threads) thread.join();
+
+    Load_Stats total;
+    for (auto& s : stats) total.merge(s);
+    return total;
+}
@@ -0,0 +1,62 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Latency_Histogram.h"
+
+struct Load_Config {
+    std::string host = "127.0.0.1";
+    unsigned short port = 8080;
+    std::string protocol = "echo";      // echo | http | websocket
+    std::string path = "/hello";        // http only
+    std::vector<std::string> headers;   // http only, extra "Name: value" request headers
+    std::size_t connections = 100;
+    std::size_t threads = 1;
+    std::size_t message_size = 64;      // echo and websocket payload
+    std::size_t local_addrs = 1;        // > 1: bind to 127.0.0.1..N, ~28k ephemeral ports each
+    double rate = 0;                    // total requests/s, 0 = closed loop
+    double deadline_ms = 0;             // replies slower than this are late, not goodput; 0 = none
+    double warmup_seconds = 1;
+    double seconds = 10;
+};
+
+struct Load_Stats {
+    Latency_Histogram latency;          // ns
+    std::uint64_t requests = 0;         // completed while recording, rejections excluded
+    std::uint64_t rejected = 0;         // answered 503 while recording
+    std::uint64_t late = 0;             // of requests, slower than the deadline
+    std::uint64_t bytes_in = 0;
+    std::uint64_t bytes_out = 0;
+    std::uint64_t errors = 0;
+    std::uint64_t reconnects = 0;
+
+    void merge(const Load_Stats& other);
+};
+
+// N connections spread over a fixed set of io_context threads, each with at
+// most one request in flight.
+//   - closed loop: the next request goes out when the reply arrives, latency
+//     is measured from the actual send
+//   - open loop (rate > 0): request k of a connection is due at a fixed time;
+//     if the previous reply is late the request waits, but its latency is
+//     still measured from when it was due (coordinated omission correction)
+class Load_Generator {
+public:
+    explicit Load_Generator(const Load_Config& config);
+
+    // Connects, warms up, records for config.seconds; blocks until done.
+    Load_Stats run();
+
+    double measured_seconds() const {
+        return measured_seconds_;
+    }
+
+private:
+    Load_Config config_;
+    double measured_seconds_ = 0;
+};
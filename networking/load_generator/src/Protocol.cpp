@@ -0,0 +1,202 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Protocol.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+    bool iequals(std::string_view a, std::string_view b) {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+            return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+        });
+    }
+
+    std::string_view trim(std::string_view s) {
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+        return s;
+    }
+
+    // "#<hex id>;" followed by filler up to the requested size.
+    void make_payload(std::string& out, std::uint64_t id, std::size_t size) {
+        std::array<char, 16> hex{};
+        auto end = std::to_chars(hex.data(), hex.data() + hex.size(), id, 16).ptr;
+
+        std::size_t start = out.size();
+        out += '#';
+        out.append(hex.data(), end);
+        out += ';';
+        if (out.size() - start < size) out.append(size - (out.size() - start), 'x');
+    }
+
+    bool has_id(std::string_view payload, std::uint64_t id) {
+        std::string tag;
+        make_payload(tag, id, 0);
+        return payload.find(tag) != std::string_view::npos;
+    }
+
+    // Bytes of a chunked body, from its first chunk through the trailer's empty
+    // line; 0 = need more. Throws on a malformed chunk size.
+    std::size_t chunked_size(std::string_view body) {
+        std::size_t at = 0;
+        for (;;) {
+            std::size_t line_end = body.find("\r\n", at);
+            if (line_end == std::string_view::npos) return 0;
+            std::size_t size = 0;
+            auto [end, ec] = std::from_chars(body.data() + at, body.data() + line_end, size, 16);
+            if (ec != std::errc() || end == body.data() + at) throw std::runtime_error("bad chunk size");
+            at = line_end + 2;
+            if (size == 0) break;
+            if (size >= body.size() || body.size() - at < size + 2) return 0;
+            at += size + 2;                             // data and its CRLF
+        }
+        // Trailer fields, if any, end with an empty line.
+        if (body.substr(at).starts_with("\r\n")) return at + 2;
+        std::size_t trailer_end = body.find("\r\n\r\n", at);
+        return trailer_end == std::string_view::npos ? 0 : trailer_end + 4;
+    }
+
+    constexpr std::array<unsigned char, 4> mask_key = {0x37, 0xfa, 0x21, 0x3d};
+}
+
+Echo_Protocol::Echo_Protocol(std::size_t message_size)
+    : message_size_(message_size) {}
+
+void Echo_Protocol::make_request(std::string& out, std::uint64_t) const {
+    out.append(message_size_, 'x');
+}
+
+Reply Echo_Protocol::parse_reply(std::string_view in, std::uint64_t) const {
+    if (in.size() < message_size_) return {};
+    return {message_size_, true, false};
+}
+
+Http_Protocol::Http_Protocol(std::string host, std::string path, const std::vector<std::string>& headers)
+    : request_("GET " + path + " HTTP/1.1\r\nHost: " + host + "\r\n")
+{
+    for (const std::string& header : headers) request_ += header + "\r\n";
+    request_ += "\r\n";
+}
+
+void Http_Protocol::make_request(std::string& out, std::uint64_t) const {
+    out += request_;
+}
+
+Reply Http_Protocol::parse_reply(std::string_view in, std::uint64_t) const {
+    std::size_t header_end = in.find("\r\n\r\n");
+    if (header_end == std::string_view::npos) return {};
+
+    if (!in.starts_with("HTTP/1.")) throw std::runtime_error("not an HTTP response");
+
+    std::size_t content_length = 0;
+    bool chunked = false;
+    bool close = false;
+    std::string_view headers = in.substr(0, header_end);
+    std::size_t line_start = headers.find("\r\n");
+
+    while (line_start != std::string_view::npos) {
+        line_start += 2;
+        std::size_t line_end = headers.find("\r\n", line_start);
+        std::string_view line = headers.substr(line_start, line_end == std::string_view::npos ? headers.npos : line_end - line_start);
+
+        std::size_t colon = line.find(':');
+        if (colon != std::string_view::npos) {
+            std::string_view key = trim(line.substr(0, colon));
+            std::string_view value = trim(line.substr(colon + 1));
+            if (iequals(key, "Content-Length")) {
+                std::from_chars(value.data(), value.data() + value.size(), content_length);
+            } else if (iequals(key, "Transfer-Encoding")) {
+                chunked = value.size() >= 7 && iequals(value.substr(value.size() - 7), "chunked");
+            } else if (iequals(key, "Connection")) {
+                close = iequals(value, "close");
+            }
+        }
+        line_start = line_end;
+    }
+
+    std::size_t total = header_end + 4 + content_length;
+    if (chunked) {
+        std::size_t body = chunked_size(in.substr(header_end + 4));
+        if (body == 0) return {};
+        total = header_end + 4 + body;
+    }
+    if (in.size() < total) return {};
+    return {total, true, close, in.substr(9, 3) == "503"};
+}
+
+WebSocket_Protocol::WebSocket_Protocol(std::string host, std::size_t message_size)
+    : host_(std::move(host)), message_size_(message_size) {}
+
+std::string WebSocket_Protocol::handshake() const {
+    return "GET / HTTP/1.1\r\n"
+           "Host: " + host_ + "\r\n"
+           "Upgrade: websocket\r\n"
+           "Connection: Upgrade\r\n"
+           "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+           "Sec-WebSocket-Version: 13\r\n\r\n";
+}
+
+std::size_t WebSocket_Protocol::handshake_reply(std::string_view in) const {
+    std::size_t header_end = in.find("\r\n\r\n");
+    if (header_end == std::string_view::npos) return 0;
+    if (!in.starts_with("HTTP/1.1 101")) throw std::runtime_error("websocket upgrade refused");
+    return header_end + 4;
+}
+
+void WebSocket_Protocol::make_request(std::string& out, std::uint64_t id) const {
+    std::string payload;
+    make_payload(payload, id, message_size_);
+
+    out += static_cast<char>(0x81);                      // FIN + text
+    if (payload.size() < 126) {
+        out += static_cast<char>(0x80 | payload.size());
+    } else if (payload.size() <= 0xffff) {
+        out += static_cast<char>(0x80 | 126);
+        out += static_cast<char>((payload.size() >> 8) & 0xff);
+        out += static_cast<char>(payload.size() & 0xff);
+    } else {
+        out += static_cast<char>(0x80 | 127);
+        for (int shift = 56; shift >= 0; shift -= 8) out += static_cast<char>((payload.size() >> shift) & 0xff);
+    }
+    out.append(reinterpret_cast<const char*>(mask_key.data()), mask_key.size());
+    for (std::size_t i = 0; i < payload.size(); ++i) {
+        out += static_cast<char>(payload[i] ^ mask_key[i % 4]);
+    }
+}
+
+Reply WebSocket_Protocol::parse_reply(std::string_view in, std::uint64_t id) const {
+    if (in.size() < 2) return {};
+    auto byte = [&in](std::size_t i) { return static_cast<unsigned char>(in[i]); };
+
+    std::size_t length = byte(1) & 0x7f;
+    std::size_t header = 2;
+    if (length == 126) {
+        if (in.size() < 4) return {};
+        length = (std::size_t(byte(2)) << 8) | byte(3);
+        header = 4;
+    } else if (length == 127) {
+        if (in.size() < 10) return {};
+        length = 0;
+        for (std::size_t i = 2; i < 10; ++i) length = (length << 8) | byte(i);
+        header = 10;
+    }
+    if (byte(1) & 0x80) header += 4;                     // servers must not mask, but skip it if they do
+    if (in.size() < header + length) return {};
+
+    bool close = (byte(0) & 0x0f) == 0x8;
+    return {header + length, has_id(in.substr(header, length), id), close};
+}
+
+std::unique_ptr<Protocol> make_protocol(const std::string& name, const std::string& host,
+                                        const std::string& path, std::size_t message_size,
+                                        const std::vector<std::string>& headers) {
+    if (name == "echo") return std::make_unique<Echo_Protocol>(message_size);
+    if (name == "http") return std::make_unique<Http_Protocol>(host, path, headers);
+    if (name == "websocket") return std::make_unique<WebSocket_Protocol>(host, message_size);
+    throw std::invalid_argument("unknown protocol: " + name);
+}
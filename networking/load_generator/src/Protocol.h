@@ -0,0 +1,84 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// What one connection sends and how it recognizes the reply. A request carries
+// a unique id so protocols that deliver other traffic on the same connection
+// (chat broadcasts) can tell their own reply apart.
+struct Reply {
+    std::size_t consumed = 0;       // bytes of the receive buffer that can be dropped, 0 = need more
+    bool matched = false;           // consumed bytes completed the outstanding request
+    bool close = false;             // server will close after this reply
+    bool rejected = false;          // the server shed the request (503), not counted as served
+};
+
+class Protocol {
+public:
+    virtual ~Protocol() = default;
+
+    virtual std::string_view name() const = 0;
+
+    // Sent once after connect; empty means the connection is ready right away.
+    virtual std::string handshake() const { return {}; }
+
+    // Bytes of the handshake reply consumed, 0 = need more; throws if refused.
+    virtual std::size_t handshake_reply(std::string_view) const { return 0; }
+
+    virtual void make_request(std::string& out, std::uint64_t id) const = 0;
+    virtual Reply parse_reply(std::string_view in, std::uint64_t id) const = 0;
+};
+
+// Every reply is exactly the request echoed back.
+class Echo_Protocol : public Protocol {
+public:
+    explicit Echo_Protocol(std::size_t message_size);
+
+    std::string_view name() const override { return "echo"; }
+    void make_request(std::string& out, std::uint64_t id) const override;
+    Reply parse_reply(std::string_view in, std::uint64_t id) const override;
+
+private:
+    std::size_t message_size_;
+};
+
+// Keep-alive GET requests; replies are framed by Content-Length or chunked, 503 replies are rejections.
+class Http_Protocol : public Protocol {
+public:
+    Http_Protocol(std::string host, std::string path, const std::vector<std::string>& headers = {});
+
+    std::string_view name() const override { return "http"; }
+    void make_request(std::string& out, std::uint64_t id) const override;
+    Reply parse_reply(std::string_view in, std::uint64_t id) const override;
+
+private:
+    std::string request_;
+};
+
+// Masked text frames after an upgrade handshake. The chat server broadcasts
+// every message to everybody, so a reply matches only if it carries our id.
+class WebSocket_Protocol : public Protocol {
+public:
+    WebSocket_Protocol(std::string host, std::size_t message_size);
+
+    std::string_view name() const override { return "websocket"; }
+    std::string handshake() const override;
+    std::size_t handshake_reply(std::string_view in) const override;
+    void make_request(std::string& out, std::uint64_t id) const override;
+    Reply parse_reply(std::string_view in, std::uint64_t id) const override;
+
+private:
+    std::string host_;
+    std::size_t message_size_;
+};
+
+std::unique_ptr<Protocol> make_protocol(const std::string& name, const std::string& host,
+                                        const std::string& path, std::size_t message_size,
+                                        const std::vector<std::string>& headers = {});
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <algorithm>
+#include "Load_Generator.h"
+
+static bool parse_args(int argc, char* argv[], Load_Config& config, bool& json) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+
+        if (arg == "--host") config.host = value;
+        else if (arg == "--port") config.port = static_cast<unsigned short>(std::stoul(value));
+        else if (arg == "--protocol") config.protocol = value;
+        else if (arg == "--path") config.path = value;
+        else if (arg == "--header") config.headers.push_back(value);
+        else if (arg == "--connections") config.connections = std::max(1ul, std::stoul(value));
+        else if (arg == "--threads") config.threads = std::max(1ul, std::stoul(value));
+        else if (arg == "--size") config.message_size = std::max(1ul, std::stoul(value));
+        else if (arg == "--local-addrs") config.local_addrs = std::max(1ul, std::stoul(value));
+        else if (arg == "--rate") config.rate = std::stod(value);
+        else if (arg == "--deadline") config.deadline_ms = std::stod(value);
+        else if (arg == "--warmup") config.warmup_seconds = std::stod(value);
+        else if (arg == "--seconds") config.seconds = std::stod(value);
+        else return false;
+    }
+    return config.protocol == "echo" || config.protocol == "http" || config.protocol == "websocket";
+}
+
+static void print_json(const Load_Config& config, const Load_Stats& stats, double seconds) {
+    auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+
+    std::cout << "{\"protocol\": \"" << config.protocol << "\""
+              << ", \"mode\": \"" << (config.rate > 0 ? "open" : "closed") << "\""
+              << ", \"target_rate\": " << config.rate
+              << ", \"connections\": " << config.connections
+              << ", \"seconds\": " << seconds
+              << ", \"requests\": " << stats.requests
+              << ", \"rps\": " << static_cast<double>(stats.requests) / seconds
+              << ", \"rejected\": " << stats.rejected
+              << ", \"late\": " << stats.late
+              << ", \"goodput\": " << static_cast<double>(stats.requests - stats.late) / seconds
+              << ", \"errors\": " << stats.errors
+              << ", \"reconnects\": " << stats.reconnects
+              << ", \"bytes_in\": " << stats.bytes_in
+              << ", \"bytes_out\": " << stats.bytes_out
+              << ", \"latency_us\": {\"min\": " << us(stats.latency.min())
+              << ", \"mean\": " << stats.latency.mean() / 1000.0
+              << ", \"p50\": " << us(stats.latency.percentile(50))
+              << ", \"p90\": " << us(stats.latency.percentile(90))
+              << ", \"p99\": " << us(stats.latency.percentile(99))
+              << ", \"p999\": " << us(stats.latency.percentile(99.9))
+              << ", \"p9999\": " << us(stats.latency.percentile(99.99))
+              << ", \"max\": " << us(stats.latency.max()) << "}}\n";
+}
+
+static void print_report(const Load_Config& config, const Load_Stats& stats, double seconds) {
+    auto us = [](std::uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
+    auto mb_per_s = [seconds](std::uint64_t bytes) { return static_cast<double>(bytes) / seconds / (1024 * 1024); };
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Target:      " << config.host << ':' << config.port << " (" << config.protocol;
+    if (config.protocol == "http") std::cout << " GET " << config.path;
+    std::cout << ")\n";
+    if (config.rate > 0) {
+        std::cout << "Mode:        open loop at " << config.rate << " req/s, latency from due time\n";
+    } else {
+        std::cout << "Mode:        closed loop, latency from send time\n";
+    }
+    std::cout << "Connections: " << config.connections << " over " << config.threads << " threads\n"
+              << "Duration:    " << seconds << " s after " << config.warmup_seconds << " s warmup\n"
+              << "Requests:    " << stats.requests << " (" << static_cast<double>(stats.requests) / seconds << " req/s)\n"
+              << "Rejected:    " << stats.rejected << " (503, " << static_cast<double>(stats.rejected) / seconds << "/s)\n";
+    if (config.deadline_ms > 0) {
+        std::cout << "Goodput:     " << static_cast<double>(stats.requests - stats.late) / seconds << " req/s within "
+                  << config.deadline_ms << " ms (" << stats.late << " late)\n";
+    }
+    std::cout
+              << "Errors:      " << stats.errors << ", reconnects " << stats.reconnects << '\n'
+              << "Transfer:    in " << mb_per_s(stats.bytes_in) << " MB/s, out " << mb_per_s(stats.bytes_out) << " MB/s\n"
+              << "Latency (us):\n"
+              << "  min    " << us(stats.latency.min()) << '\n'
+              << "  mean   " << stats.latency.mean() / 1000.0 << '\n'
+              << "  p50    " << us(stats.latency.percentile(50)) << '\n'
+              << "  p90    " << us(stats.latency.percentile(90)) << '\n'
+              << "  p99    " << us(stats.latency.percentile(99)) << '\n'
+              << "  p99.9  " << us(stats.latency.percentile(99.9)) << '\n'
+              << "  p99.99 " << us(stats.latency.percentile(99.99)) << '\n'
+              << "  max    " << us(stats.latency.max()) << '\n';
+}
+
+int main(int argc, char* argv[]) {
+    Load_Config config;
+    bool json = false;
+    if (!parse_args(argc, argv, config, json)) {
+        std::cout << "Usage: " << argv[0] << " [--protocol echo|http|websocket] [--host H] [--port P] [--path /p] [--header H]...\n"
+                  << "       [--connections N] [--threads T] [--size BYTES] [--local-addrs K]\n"
+                  << "       [--rate REQ_PER_S] [--deadline MS] [--warmup S] [--seconds S] [--json]\n";
+        return 2;
+    }
+
+    try {
+        Load_Generator generator(config);
+        Load_Stats stats = generator.run();
+
+        if (json) {
+            print_json(config, stats, generator.measured_seconds());
+        } else {
+            print_report(config, stats, generator.measured_seconds());
+        }
+    } catch (std::exception& e) {
+        std::cout << "Load generator error: " << e.what() << '\n';
+        return 1;
+    }
+}
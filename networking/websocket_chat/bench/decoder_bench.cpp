@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "WebSocket_Frame.h"
+
+using Clock = std::chrono::steady_clock;
+
+// The decoder websocket_chat used before Frame_Decoder, kept verbatim as the
+// baseline: one whole frame per call, 16-bit lengths, byte-by-byte unmasking.
+struct WSFrame {
+    bool fin;
+    unsigned char opcode;
+    std::string payload;
+};
+
+static WSFrame decode_frame(const unsigned char* data, std::size_t length) {
+    WSFrame frame;
+    if (length < 2) throw std::runtime_error("Frame too short");
+
+    unsigned char fin_rsv_opcode = data[0];
+    unsigned char mask_payload_len = data[1];
+
+    frame.fin = fin_rsv_opcode & 0x80;
+    frame.opcode = fin_rsv_opcode & 0x0F;
+
+    std::size_t payload_len = mask_payload_len & 0x7F;
+    std::size_t header_size = 2;
+
+    std::array<unsigned char, 4> mask_key{};
+    if (payload_len == 126) {
+        payload_len = (data[2] << 8) | data[3];
+        header_size += 2;
+    } else if (payload_len == 127) {
+        throw std::runtime_error("Payload too big");
+    }
+
+    bool masked = mask_payload_len & 0x80;
+    if (masked) {
+        for (int i = 0; i < 4; ++i) mask_key[i] = data[header_size + i];
+        header_size += 4;
+    }
+
+    frame.payload.resize(payload_len);
+    for (std::size_t i = 0; i < payload_len; ++i) {
+        unsigned char byte = data[header_size + i];
+        if (masked) byte ^= mask_key[i % 4];
+        frame.payload[i] = byte;
+    }
+
+    return frame;
+}
+
+static void unmask_bytewise(unsigned char* data, std::size_t size, const std::array<unsigned char, 4>& key) {
+    for (std::size_t i = 0; i < size; ++i) data[i] ^= key[i % 4];
+}
+
+static void unmask_64(unsigned char* data, std::size_t size, const std::array<unsigned char, 4>& key) {
+    std::uint32_t key32;
+    std::memcpy(&key32, key.data(), 4);
+    const std::uint64_t key64 = (static_cast<std::uint64_t>(key32) << 32) | key32;
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        word ^= key64;
+        std::memcpy(data + i, &word, 8);
+    }
+    for (; i < size; ++i) data[i] ^= key[i & 3];
+}
+
+static const std::array<unsigned char, 4> mask_key = {0x37, 0xfa, 0x21, 0x3d};
+
+// Frames of `payload_size` bytes, masked as a client sends them, back to back.
+static std::vector<unsigned char> make_stream(std::size_t payload_size, std::size_t total) {
+    std::mt19937 random(42);
+    std::vector<unsigned char> stream;
+    while (stream.size() < total || stream.empty()) {
+        stream.push_back(0x81);
+        if (payload_size < 126) {
+            stream.push_back(static_cast<unsigned char>(0x80 | payload_size));
+        } else if (payload_size <= 0xFFFF) {
+            stream.push_back(0x80 | 126);
+            stream.push_back((payload_size >> 8) & 0xFF);
+            stream.push_back(payload_size & 0xFF);
+        } else {
+            stream.push_back(0x80 | 127);
+            for (int shift = 56; shift >= 0; shift -= 8) stream.push_back((static_cast<std::uint64_t>(payload_size) >> shift) & 0xFF);
+        }
+        stream.insert(stream.end(), mask_key.begin(), mask_key.end());
+        for (std::size_t i = 0; i < payload_size; ++i) stream.push_back(static_cast<unsigned char>('a' + random() % 26) ^ mask_key[i % 4]);
+    }
+    return stream;
+}
+
+static volatile std::size_t sink;
+
+// Runs `pass` (which handles `bytes`) until min_seconds passed; returns GB/s.
+template <typename F>
+static double measure(F&& pass, std::size_t bytes, double min_seconds) {
+    std::size_t passes = 0;
+    auto start = Clock::now();
+    double elapsed = 0;
+    do {
+        pass();
+        ++passes;
+        elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    } while (elapsed < min_seconds);
+    return static_cast<double>(bytes) * static_cast<double>(passes) / elapsed / 1e9;
+}
+
+int main(int argc, char* argv[]) {
+    double min_seconds = 0.5;
+    std::size_t read_size = 16 * 1024;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--seconds") min_seconds = std::stod(argv[i + 1]);
+        else if (arg == "--read") read_size = std::max(1ul, std::stoul(argv[i + 1]));
+    }
+
+    std::cout << "unmask (GB/s)\n"
+              << std::left << std::setw(10) << "bytes" << std::right << std::setw(12) << "bytewise"
+              << std::setw(12) << "64-bit" << std::setw(12) << "unmask()" << '\n' << std::fixed << std::setprecision(2);
+    for (std::size_t size : {128ul, 1024ul, 16ul * 1024, 1024ul * 1024}) {
+        std::vector<unsigned char> data(size, 'x');
+        double bytewise = measure([&]() { unmask_bytewise(data.data(), size, mask_key); sink = sink + data[0]; }, size, min_seconds);
+        double wide = measure([&]() { unmask_64(data.data(), size, mask_key); sink = sink + data[0]; }, size, min_seconds);
+        double simd = measure([&]() { unmask(data.data(), size, mask_key); sink = sink + data[0]; }, size, min_seconds);
+        std::cout << std::left << std::setw(10) << size << std::right << std::setw(12) << bytewise
+                  << std::setw(12) << wide << std::setw(12) << simd << '\n';
+    }
+
+    // A stream of frames fed to the decoder in read_size pieces, as the server
+    // reads them; the legacy decoder gets one frame per call (all it handles).
+    std::cout << "\ndecode (GB/s of frames), " << read_size << "-byte reads\n"
+              << std::left << std::setw(10) << "payload" << std::right << std::setw(12) << "legacy"
+              << std::setw(12) << "decoder" << std::setw(10) << "speedup" << '\n';
+    for (std::size_t payload_size : {16ul, 125ul, 1000ul, 16ul * 1024, 1024ul * 1024}) {
+        std::vector<unsigned char> stream = make_stream(payload_size, 4 * 1024 * 1024);
+
+        double legacy = 0;
+        if (payload_size <= 0xFFFF) {
+            legacy = measure([&]() {
+                for (std::size_t at = 0; at < stream.size();) {
+                    std::size_t header = stream[at + 1] == (0x80 | 126) ? 8 : 6;
+                    WSFrame frame = decode_frame(stream.data() + at, header + payload_size);
+                    sink = sink + frame.payload.size();
+                    at += header + payload_size;
+                }
+            }, stream.size(), min_seconds);
+        }
+
+        Frame_Decoder decoder(2 * 1024 * 1024);
+        std::size_t messages = 0;
+        double decoded = measure([&]() {
+            for (std::size_t at = 0; at < stream.size();) {
+                std::size_t size = std::min(read_size, stream.size() - at);
+                unsigned char* data = stream.data() + at;
+                at += size;
+                while (size > 0) {
+                    std::size_t consumed = 0;
+                    Frame_Decoder::Status status = decoder.next(data, size, consumed);
+                    if (status == Frame_Decoder::Status::Error) std::abort();
+                    if (status == Frame_Decoder::Status::Message) {
+                        sink = sink + decoder.payload().size();
+                        ++messages;
+                    }
+                    data += consumed;
+                    size -= consumed;
+                }
+            }
+        }, stream.size(), min_seconds);
+
+        std::cout << std::left << std::setw(10) << payload_size << std::right << std::setw(12);
+        if (legacy > 0) std::cout << legacy; else std::cout << "-";
+        std::cout << std::setw(12) << decoded << std::setw(9);
+        if (legacy > 0) std::cout << decoded / legacy << "x\n"; else std::cout << "-" << "\n";
+        if (messages == 0) std::abort();
+    }
+}
@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <zlib.h>
+
+using Clock = std::chrono::steady_clock;
+
+// Broadcast fan-out against a running websocket_chat: one subscriber publishes
+// a message, every subscriber (the publisher included) waits for the broadcast
+// carrying its tag, and the next message goes out once all got it or the
+// round timed out. Stalled clients join but never read, so their send queues
+// (or, with blocking writes, their socket buffers) fill up. With --deflate
+// every client offers permessage-deflate and inflates compressed broadcasts;
+// bytes received are counted off the wire either way. With --rooms R every
+// subscriber joins one of R rooms and the messages go to the rooms in turn,
+// each published by a member and awaited by that room's members only; with
+// --late N as well, N clients join a room afterwards asking for its history
+// and wait for the replay to reach the room's last message.
+
+struct Subscriber {
+    int fd = -1;
+    std::string buffer;
+    bool got = false;
+    std::unique_ptr<z_stream> inflater;     // if permessage-deflate was negotiated
+    std::size_t received = 0;               // bytes read from the socket
+};
+
+static int connect_client(unsigned short port, int receive_buffer, bool deflate, bool* negotiated = nullptr) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error("socket failed (raise ulimit -n)");
+    if (receive_buffer > 0) ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer, sizeof(receive_buffer));
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("connect failed");
+    }
+
+    std::string request = "GET / HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                          "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n";
+    if (deflate) request += "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n";
+    request += "\r\n";
+    if (::send(fd, request.data(), request.size(), 0) != static_cast<ssize_t>(request.size())) {
+        throw std::runtime_error("handshake send failed");
+    }
+    // The 101 is read byte by byte so no frame after it is consumed.
+    std::string reply;
+    char c;
+    while (!reply.ends_with("\r\n\r\n")) {
+        if (::recv(fd, &c, 1, 0) != 1) throw std::runtime_error("handshake failed");
+        reply += c;
+    }
+    if (!reply.starts_with("HTTP/1.1 101")) throw std::runtime_error("upgrade refused");
+    if (negotiated) *negotiated = reply.find("permessage-deflate") != std::string::npos;
+    return fd;
+}
+
+static std::string masked_frame(std::string_view payload) {
+    static constexpr unsigned char mask[4] = {0x12, 0x34, 0x56, 0x78};
+    std::string out;
+    out += static_cast<char>(0x81);
+    if (payload.size() < 126) {
+        out += static_cast<char>(0x80 | payload.size());
+    } else {
+        out += static_cast<char>(0x80 | 126);
+        out += static_cast<char>((payload.size() >> 8) & 0xff);
+        out += static_cast<char>(payload.size() & 0xff);
+    }
+    out.append(reinterpret_cast<const char*>(mask), 4);
+    for (std::size_t i = 0; i < payload.size(); ++i) out += static_cast<char>(payload[i] ^ mask[i % 4]);
+    return out;
+}
+
+// Chat-like text: words drawn from a small vocabulary, different for every message.
+static std::string chat_text(std::size_t size, std::mt19937& random) {
+    static const char* words[] = {
+        "hey", "anyone", "seen", "the", "new", "build", "it", "is", "way", "faster", "than", "before", "lol",
+        "server", "deploy", "tonight", "after", "standup", "can", "you", "check", "logs", "for", "errors",
+        "thanks", "looks", "good", "to", "me", "will", "merge", "later", "coffee", "meeting", "moved", "friday",
+    };
+    std::string text;
+    while (text.size() < size) {
+        if (!text.empty()) text += ' ';
+        text += words[random() % std::size(words)];
+    }
+    text.resize(size);
+    return text;
+}
+
+// Inflates a compressed payload with the subscriber's stream, the tail put back.
+static std::string inflate_payload(z_stream& stream, std::string_view payload) {
+    std::string in(payload);
+    in.append("\x00\x00\xff\xff", 4);
+    stream.next_in = reinterpret_cast<Bytef*>(in.data());
+    stream.avail_in = static_cast<uInt>(in.size());
+    std::string out;
+    char chunk[16 * 1024];
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(chunk);
+        stream.avail_out = sizeof(chunk);
+        int result = inflate(&stream, Z_SYNC_FLUSH);
+        if (result != Z_OK && result != Z_BUF_ERROR) throw std::runtime_error("inflate failed");
+        out.append(chunk, sizeof(chunk) - stream.avail_out);
+    } while (stream.avail_in > 0 || stream.avail_out == 0);
+    return out;
+}
+
+// Consumes the complete frames in `buffer`; true if one of them carries `tag`.
+static bool take_frames(std::string& buffer, std::string_view tag, z_stream* inflater) {
+    bool found = false;
+    std::size_t at = 0;
+    for (;;) {
+        std::string_view in(buffer.data() + at, buffer.size() - at);
+        if (in.size() < 2) break;
+        std::size_t length = static_cast<unsigned char>(in[1]) & 0x7f;
+        std::size_t header = 2;
+        if (length == 126) {
+            if (in.size() < 4) break;
+            length = (std::size_t(static_cast<unsigned char>(in[2])) << 8) | static_cast<unsigned char>(in[3]);
+            header = 4;
+        } else if (length == 127) {
+            if (in.size() < 10) break;
+            length = 0;
+            for (std::size_t i = 2; i < 10; ++i) length = (length << 8) | static_cast<unsigned char>(in[i]);
+            header = 10;
+        }
+        if (in.size() < header + length) break;
+        std::string_view payload = in.substr(header, length);
+        if (inflater && (static_cast<unsigned char>(in[0]) & 0x40)) {
+            if (inflate_payload(*inflater, payload).find(tag) != std::string::npos) found = true;
+        } else if (payload.find(tag) != std::string_view::npos) {
+            found = true;
+        }
+        at += header + length;
+    }
+    buffer.erase(0, at);
+    return found;
+}
+
+// User plus system CPU time of a process so far, from /proc; 0 without one.
+static double cpu_seconds(long pid) {
+    if (pid <= 0) return 0;
+    std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
+    std::string stat((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::istringstream fields(stat.substr(stat.rfind(')') + 2));  // the name may contain spaces
+    std::string field;
+    double ticks = 0;
+    for (int i = 3; i <= 15 && fields >> field; ++i) {
+        if (i >= 14) ticks += std::stod(field);                     // utime, stime
+    }
+    return ticks / static_cast<double>(::sysconf(_SC_CLK_TCK));
+}
+
+static double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0;
+    std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(p * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+int main(int argc, char* argv[]) {
+    unsigned short port = 8080;
+    std::size_t subscribers = 100;
+    std::size_t stalled = 0;
+    std::size_t messages = 200;
+    std::size_t size = 128;
+    double timeout = 2;
+    long server_pid = 0;
+    bool deflate = false;
+    std::size_t rooms = 0;
+    std::size_t late = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--port") port = static_cast<unsigned short>(std::stoul(argv[i + 1]));
+        else if (arg == "--subscribers") subscribers = std::max(1ul, std::stoul(argv[i + 1]));
+        else if (arg == "--stalled") stalled = std::stoul(argv[i + 1]);
+        else if (arg == "--messages") messages = std::stoul(argv[i + 1]);
+        else if (arg == "--size") size = std::min(60000ul, std::stoul(argv[i + 1]));
+        else if (arg == "--timeout") timeout = std::stod(argv[i + 1]);
+        else if (arg == "--server-pid") server_pid = std::stol(argv[i + 1]);
+        else if (arg == "--deflate") deflate = std::stoul(argv[i + 1]) != 0;
+        else if (arg == "--rooms") rooms = std::stoul(argv[i + 1]);
+        else if (arg == "--late") late = std::stoul(argv[i + 1]);
+    }
+
+    rooms = std::min(rooms, subscribers);
+
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    std::vector<int> stalled_fds;
+    for (std::size_t i = 0; i < stalled; ++i) stalled_fds.push_back(connect_client(port, 4096, deflate));
+
+    int epoll = ::epoll_create1(0);
+    std::vector<Subscriber> subs(subscribers);
+    std::size_t compressing = 0;
+    for (std::size_t i = 0; i < subscribers; ++i) {
+        bool negotiated = false;
+        subs[i].fd = connect_client(port, 0, deflate, &negotiated);
+        if (negotiated) {
+            subs[i].inflater = std::make_unique<z_stream>();
+            if (inflateInit2(subs[i].inflater.get(), -15) != Z_OK) throw std::runtime_error("inflateInit2 failed");
+            ++compressing;
+        }
+        if (rooms > 0) {
+            std::string join = masked_frame("/join room" + std::to_string(i % rooms));
+            ::send(subs[i].fd, join.data(), join.size(), 0);
+        }
+        ::fcntl(subs[i].fd, F_SETFL, ::fcntl(subs[i].fd, F_GETFL) | O_NONBLOCK);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        ::epoll_ctl(epoll, EPOLL_CTL_ADD, subs[i].fd, &event);
+    }
+
+    if (rooms > 0) ::sleep(1);                      // for the joins to be processed
+
+    std::vector<double> delivery_us;                // every subscriber's latency of every message
+    std::vector<double> fanout_us;                  // per message, until the last subscriber got it
+    std::size_t missing = 0;
+    std::size_t expected = 0;                       // deliveries
+    std::vector<epoll_event> events(1024);
+    std::vector<char> chunk(1 << 16);
+
+    std::mt19937 random(42);
+    double server_cpu = cpu_seconds(server_pid);
+    auto started = Clock::now();
+    for (std::size_t m = 0; m < messages; ++m) {
+        std::string tag = "#" + std::to_string(m) + ":";
+        std::string payload = tag + chat_text(size > tag.size() ? size - tag.size() : 0, random);
+        std::size_t publisher = 0;
+        std::size_t recipients = subscribers;
+        if (rooms > 0) {
+            // Subscriber r is the first member of room r.
+            std::size_t room = m % rooms;
+            publisher = room;
+            recipients = subscribers / rooms + (room < subscribers % rooms ? 1 : 0);
+            payload = "/to room" + std::to_string(room) + " " + payload;
+        }
+        std::string frame = masked_frame(payload);
+        for (Subscriber& sub : subs) sub.got = false;
+
+        auto sent = Clock::now();
+        ::send(subs[publisher].fd, frame.data(), frame.size(), 0);
+
+        std::size_t pending = recipients;
+        expected += recipients;
+        double last = 0;
+        while (pending > 0) {
+            double waited = std::chrono::duration<double>(Clock::now() - sent).count();
+            if (waited > timeout) break;
+            int ready = ::epoll_wait(epoll, events.data(), static_cast<int>(events.size()), 100);
+            for (int e = 0; e < ready; ++e) {
+                Subscriber& sub = subs[events[e].data.u64];
+                ssize_t n;
+                while ((n = ::recv(sub.fd, chunk.data(), chunk.size(), 0)) > 0) {
+                    sub.buffer.append(chunk.data(), n);
+                    sub.received += static_cast<std::size_t>(n);
+                }
+                if (take_frames(sub.buffer, tag, sub.inflater.get()) && !sub.got) {
+                    sub.got = true;
+                    --pending;
+                    last = std::chrono::duration<double, std::micro>(Clock::now() - sent).count();
+                    delivery_us.push_back(last);
+                }
+            }
+        }
+        missing += pending;
+        if (pending == 0) fanout_us.push_back(last);
+        if (pending == recipients) {
+            std::cout << "nobody got message " << m << " within " << timeout << " s, server stalled\n";
+            messages = m + 1;
+            break;
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+    server_cpu = cpu_seconds(server_pid) - server_cpu;
+
+    std::cout << std::fixed << std::setprecision(0)
+              << "subscribers " << subscribers << ", rooms " << rooms << ", stalled " << stalled << ", " << messages << " messages of " << size << " B\n"
+              << "delivery latency  p50 " << percentile(delivery_us, 0.5) << " us, p99 " << percentile(delivery_us, 0.99) << " us\n"
+              << "fan-out (last)    p50 " << percentile(fanout_us, 0.5) << " us, p99 " << percentile(fanout_us, 0.99) << " us\n"
+              << std::setprecision(1)
+              << "per recipient     " << (fanout_us.empty() ? 0 : percentile(fanout_us, 0.5) * static_cast<double>(messages) / static_cast<double>(expected)) << " us\n"
+              << "messages/s        " << static_cast<double>(messages) / elapsed << "\n"
+              << "missing           " << missing << " of " << expected << " deliveries\n";
+    double deliveries = static_cast<double>(expected - missing);
+    std::size_t received = 0;
+    for (Subscriber& sub : subs) received += sub.received;
+    std::cout << "permessage-deflate " << compressing << " of " << subscribers << " subscribers\n"
+              << "wire bytes        " << static_cast<double>(received) / deliveries << " per delivery\n";
+    if (server_pid > 0) {
+        std::cout << std::setprecision(3) << "server CPU        " << server_cpu * 1e3 / static_cast<double>(messages)
+                  << " ms per message, " << std::setprecision(0) << server_cpu * 1e9 / deliveries << " ns per delivery\n";
+    }
+
+    if (rooms > 0 && late > 0 && messages >= rooms) {
+        // Late joiner j asks room j % rooms for everything from sequence 1 on.
+        std::vector<double> replay_us;
+        std::size_t replay_bytes = 0;
+        for (std::size_t j = 0; j < late; ++j) {
+            std::size_t room = j % rooms;
+            std::size_t last = (messages - 1 - room) / rooms * rooms + room;
+            std::string tag = "#" + std::to_string(last) + ":";
+            Subscriber joiner;
+            bool negotiated = false;
+            joiner.fd = connect_client(port, 0, deflate, &negotiated);
+            if (negotiated) {
+                joiner.inflater = std::make_unique<z_stream>();
+                if (inflateInit2(joiner.inflater.get(), -15) != Z_OK) throw std::runtime_error("inflateInit2 failed");
+            }
+            timeval wait{static_cast<time_t>(timeout), 0};
+            ::setsockopt(joiner.fd, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof(wait));
+            std::string join = masked_frame("/join room" + std::to_string(room) + " 1");
+
+            auto sent = Clock::now();
+            ::send(joiner.fd, join.data(), join.size(), 0);
+            bool found = false;
+            ssize_t n;
+            while (!found && (n = ::recv(joiner.fd, chunk.data(), chunk.size(), 0)) > 0) {
+                joiner.buffer.append(chunk.data(), n);
+                replay_bytes += static_cast<std::size_t>(n);
+                found = take_frames(joiner.buffer, tag, joiner.inflater.get());
+            }
+            if (found) replay_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - sent).count());
+            ::close(joiner.fd);
+            if (joiner.inflater) inflateEnd(joiner.inflater.get());
+        }
+        std::cout << std::fixed << std::setprecision(0)
+                  << "late joiners      " << replay_us.size() << " of " << late << " got the history, "
+                  << static_cast<double>(replay_bytes) / static_cast<double>(late) << " B each\n"
+                  << "replay latency    p50 " << percentile(replay_us, 0.5) << " us, p99 " << percentile(replay_us, 0.99) << " us\n";
+    }
+
+    for (Subscriber& sub : subs) {
+        ::close(sub.fd);
+        if (sub.inflater) inflateEnd(sub.inflater.get());
+    }
+    for (int fd : stalled_fds) ::close(fd);
+    ::close(epoll);
+}
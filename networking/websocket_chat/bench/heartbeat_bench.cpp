@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using Clock = std::chrono::steady_clock;
+
+// Heartbeats and idle reaping against a running websocket_chat: live
+// connections answer every ping with a pong and nothing else, silent ones
+// never read nor write, as a client that vanished would. Reports how long
+// after connecting the server closed the silent ones, that no live one was
+// closed, and what the heartbeats cost the server.
+
+struct Connection {
+    int fd = -1;
+    bool silent = false;
+    bool closed = false;
+    Clock::time_point connected;
+    std::string buffer;
+};
+
+static int connect_client(unsigned short port) {
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) throw std::runtime_error("socket failed (raise ulimit -n)");
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        throw std::runtime_error("connect failed");
+    }
+
+    std::string_view request = "GET / HTTP/1.1\r\nHost: localhost\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                               "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\nSec-WebSocket-Version: 13\r\n\r\n";
+    if (::send(fd, request.data(), request.size(), 0) != static_cast<ssize_t>(request.size())) {
+        throw std::runtime_error("handshake send failed");
+    }
+    std::string reply;
+    char c;
+    while (!reply.ends_with("\r\n\r\n")) {
+        if (::recv(fd, &c, 1, 0) != 1) throw std::runtime_error("handshake failed");
+        reply += c;
+    }
+    if (!reply.starts_with("HTTP/1.1 101")) throw std::runtime_error("upgrade refused");
+    return fd;
+}
+
+// Answers the pings among the complete frames in `buffer`; returns how many.
+static std::size_t answer_pings(Connection& connection) {
+    static constexpr unsigned char pong[6] = {0x8A, 0x80, 0, 0, 0, 0};   // empty, masked with a zero key
+    std::size_t pings = 0;
+    std::size_t at = 0;
+    while (connection.buffer.size() - at >= 2) {
+        std::size_t length = static_cast<unsigned char>(connection.buffer[at + 1]) & 0x7f;
+        if (length >= 126 || connection.buffer.size() - at < 2 + length) break;   // pings are short
+        if ((static_cast<unsigned char>(connection.buffer[at]) & 0x0f) == 0x9) {
+            ::send(connection.fd, pong, sizeof(pong), 0);
+            ++pings;
+        }
+        at += 2 + length;
+    }
+    connection.buffer.erase(0, at);
+    return pings;
+}
+
+// User plus system CPU time of a process so far, from /proc; 0 without one.
+static double cpu_seconds(long pid) {
+    if (pid <= 0) return 0;
+    std::ifstream file("/proc/" + std::to_string(pid) + "/stat");
+    std::string stat((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    std::istringstream fields(stat.substr(stat.rfind(')') + 2));  // the name may contain spaces
+    std::string field;
+    double ticks = 0;
+    for (int i = 3; i <= 15 && fields >> field; ++i) {
+        if (i >= 14) ticks += std::stod(field);                     // utime, stime
+    }
+    return ticks / static_cast<double>(::sysconf(_SC_CLK_TCK));
+}
+
+// Open descriptors of a process, from /proc; 0 without one.
+static std::size_t open_fds(long pid) {
+    if (pid <= 0) return 0;
+    DIR* dir = ::opendir(("/proc/" + std::to_string(pid) + "/fd").c_str());
+    if (!dir) return 0;
+    std::size_t count = 0;
+    while (::readdir(dir)) ++count;
+    ::closedir(dir);
+    return count - 2;                                               // . and ..
+}
+
+static double percentile(std::vector<double>& values, double p) {
+    if (values.empty()) return 0;
+    std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(p * static_cast<double>(values.size())));
+    std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+    return values[index];
+}
+
+int main(int argc, char* argv[]) {
+    unsigned short port = 8080;
+    std::size_t connections = 1000;
+    std::size_t silent = 100;
+    double seconds = 10;
+    long server_pid = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        if (arg == "--port") port = static_cast<unsigned short>(std::stoul(argv[i + 1]));
+        else if (arg == "--connections") connections = std::max(1ul, std::stoul(argv[i + 1]));
+        else if (arg == "--silent") silent = std::stoul(argv[i + 1]);
+        else if (arg == "--seconds") seconds = std::stod(argv[i + 1]);
+        else if (arg == "--server-pid") server_pid = std::stol(argv[i + 1]);
+    }
+    silent = std::min(silent, connections);
+
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    int epoll = ::epoll_create1(0);
+    std::vector<Connection> conns(connections);
+    for (std::size_t i = 0; i < connections; ++i) {
+        Connection& connection = conns[i];
+        connection.fd = connect_client(port);
+        connection.silent = i * silent / connections != (i + 1) * silent / connections;     // spread evenly
+        connection.connected = Clock::now();
+        ::fcntl(connection.fd, F_SETFL, ::fcntl(connection.fd, F_GETFL) | O_NONBLOCK);
+        epoll_event event{};
+        // A silent connection is only watched for the server hanging up, its data is never read.
+        event.events = connection.silent ? EPOLLRDHUP : EPOLLIN | EPOLLRDHUP;
+        event.data.u64 = i;
+        ::epoll_ctl(epoll, EPOLL_CTL_ADD, connection.fd, &event);
+    }
+    std::size_t silent_count = std::ranges::count_if(conns, [](const Connection& c) { return c.silent; });
+    std::cout << connections << " connections, " << silent_count << " silent, server fds " << open_fds(server_pid) << "\n";
+
+    std::vector<double> reaped_after;               // seconds from connecting to being closed, silent ones
+    std::size_t live_closed = 0;
+    std::size_t pings = 0;
+    std::vector<epoll_event> events(1024);
+    std::vector<char> chunk(1 << 16);
+
+    double server_cpu = cpu_seconds(server_pid);
+    auto started = Clock::now();
+    while (std::chrono::duration<double>(Clock::now() - started).count() < seconds) {
+        int ready = ::epoll_wait(epoll, events.data(), static_cast<int>(events.size()), 100);
+        for (int e = 0; e < ready; ++e) {
+            Connection& connection = conns[events[e].data.u64];
+            if (connection.closed) continue;
+            bool hung_up = events[e].events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR);
+            if (!connection.silent) {
+                ssize_t n;
+                while ((n = ::recv(connection.fd, chunk.data(), chunk.size(), 0)) > 0) connection.buffer.append(chunk.data(), n);
+                if (n == 0) hung_up = true;
+                pings += answer_pings(connection);
+            }
+            if (!hung_up) continue;
+
+            connection.closed = true;
+            ::epoll_ctl(epoll, EPOLL_CTL_DEL, connection.fd, nullptr);
+            if (connection.silent) {
+                reaped_after.push_back(std::chrono::duration<double>(Clock::now() - connection.connected).count());
+            } else {
+                ++live_closed;
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+    server_cpu = cpu_seconds(server_pid) - server_cpu;
+
+    std::cout << std::fixed << std::setprecision(2)
+              << "silent closed     " << reaped_after.size() << " of " << silent_count << ", after p50 "
+              << percentile(reaped_after, 0.5) << " s, p99 " << percentile(reaped_after, 0.99)
+              << " s, max " << (reaped_after.empty() ? 0 : *std::ranges::max_element(reaped_after)) << " s\n"
+              << "live closed       " << live_closed << " of " << connections - silent_count << "\n"
+              << std::setprecision(0)
+              << "pings answered    " << pings << " (" << static_cast<double>(pings) / elapsed << "/s)\n";
+    if (server_pid > 0) {
+        std::cout << std::setprecision(2) << "server CPU        " << server_cpu * 1e3 / elapsed << " ms per second"
+                  << ", server fds " << open_fds(server_pid) << "\n";
+    }
+
+    for (Connection& connection : conns) ::close(connection.fd);
+    ::close(epoll);
+}
@@ -0,0 +1,98 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Client_Session.h"
+#include <algorithm>
+
+Client_Session::Client_Session(tcp::socket socket, const Send_Queue_Options& options)
+    : socket_(std::move(socket)), options_(options)
+{
+    socket_.non_blocking(true);
+}
+
+bool Client_Session::send(const Shared_Frame& frame) {
+    return send(std::span<const Shared_Frame>(&frame, 1));
+}
+
+bool Client_Session::send(std::span<const Shared_Frame> frames) {
+    if (!socket_.is_open() || finishing_) return true;
+    std::size_t bytes = 0;
+    for (const Shared_Frame& frame : frames) bytes += frame->size();
+    if (!queue_.empty() && (queue_.size() + frames.size() > options_.max_messages ||
+                            queued_bytes_ + bytes > options_.max_bytes)) {
+        return false;
+    }
+    queued_bytes_ += bytes;
+    queue_.insert(queue_.end(), frames.begin(), frames.end());
+    if (!waiting_) write_queued();
+    return true;
+}
+
+void Client_Session::finish() {
+    finishing_ = true;
+    if (!waiting_) write_queued();
+}
+
+void Client_Session::finish(const Shared_Frame& last) {
+    if (socket_.is_open() && !finishing_) {
+        queued_bytes_ += last->size();
+        queue_.push_back(last);
+    }
+    finish();
+}
+
+void Client_Session::close() {
+    boost::system::error_code ec;
+    socket_.close(ec);
+}
+
+void Client_Session::write_queued() {
+    boost::system::error_code ec;
+    while (!queue_.empty() && !ec) {
+        buffers_.clear();
+        for (std::size_t i = 0; i < std::min(queue_.size(), max_gather); ++i) {
+            buffers_.push_back(boost::asio::buffer(*queue_[i]));
+        }
+        buffers_.front() += written_;
+
+        std::size_t length = socket_.write_some(buffers_, ec);
+        if (ec == boost::asio::error::would_block) {
+            wait_writable();
+            return;
+        }
+        consume(length);
+    }
+    if (ec) {
+        close();                    // the reader sees it and drops the client
+    } else if (finishing_ && socket_.is_open()) {
+        socket_.shutdown(tcp::socket::shutdown_send, ec);
+        close();
+    }
+}
+
+void Client_Session::wait_writable() {
+    waiting_ = true;
+    socket_.async_wait(tcp::socket::wait_write, [self = shared_from_this()](const boost::system::error_code& ec) {
+        self->waiting_ = false;
+        if (ec) {
+            self->close();
+            return;
+        }
+        self->write_queued();
+    });
+}
+
+void Client_Session::consume(std::size_t length) {
+    while (length > 0) {
+        std::size_t rest = queue_.front()->size() - written_;
+        if (length < rest) {
+            written_ += length;
+            return;
+        }
+        length -= rest;
+        queued_bytes_ -= queue_.front()->size();
+        queue_.pop_front();
+        written_ = 0;
+    }
+}
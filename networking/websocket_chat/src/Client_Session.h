@@ -0,0 +1,108 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+#include <boost/asio.hpp>
+#include "Permessage_Deflate.h"
+#include "Room_Registry.h"
+#include "Timer_Wheel.h"
+
+using boost::asio::ip::tcp;
+
+// A serialized frame shared by every client it goes to: encoded once, never
+// modified, freed when the last queue holding it has written it.
+using Shared_Frame = std::shared_ptr<const std::vector<unsigned char>>;
+
+// A message as every kind of recipient needs it, built once by the sender's
+// thread: the plain frame, one deflated frame per window size in use, and the
+// text for clients compressing with their own context. Kept as it is in the
+// history of its room (Shared_Broadcast, declared with Room_Registry).
+struct Broadcast {
+    static constexpr std::size_t window_sizes = 16;     // deflate windows are 9..15 bits; indexed by bits
+
+    std::string message;
+    Shared_Frame plain;
+    std::array<Shared_Frame, window_sizes> deflated;
+    std::uint64_t sequence = 0;                         // in its room; 0 for a broadcast to everybody
+};
+
+struct Send_Queue_Options {
+    std::size_t max_messages = 1024;                // frames waiting to be written to one client
+    std::size_t max_bytes = 4 * 1024 * 1024;        // bytes waiting to be written to one client
+};
+
+// A connected client and its outbound queue. It lives on the thread that
+// accepted it: only that thread's io_context touches the socket and the queue,
+// so neither needs a lock. send() appends and writes what the socket takes right
+// away with a non-blocking gather write; only when the send buffer is full does
+// the rest wait for writability. A client that reads slowly therefore delays
+// nobody but itself, and its queue bounds what it can hold back.
+class Client_Session : public std::enable_shared_from_this<Client_Session> {
+public:
+    Client_Session(tcp::socket socket, const Send_Queue_Options& options);
+
+    tcp::socket& socket() {
+        return socket_;
+    }
+
+    // False if the queue is full; a frame always fits into an empty queue.
+    // Frames sent after finish() are dropped.
+    bool send(const Shared_Frame& frame);
+
+    // All the frames or none; an empty queue takes any batch, and the whole
+    // batch goes out in one gather write when the socket takes it.
+    bool send(std::span<const Shared_Frame> frames);
+
+    // Closes the connection once everything queued (a close frame last) is written.
+    void finish();
+
+    // Queues `last` (a close frame) even if the queue is full, then finishes.
+    void finish(const Shared_Frame& last);
+
+    void close();
+
+    bool finishing() const {
+        return finishing_;
+    }
+
+    std::size_t slot = 0;           // index in the owning hub's client (or closing) list
+
+    std::optional<Deflate_Params> deflate;          // permessage-deflate, if negotiated
+    std::unique_ptr<Deflate_Encoder> encoder;       // own compressor, with server context takeover
+    std::unique_ptr<Deflate_Decoder> decoder;       // own decompressor, with client context takeover
+
+    Room_Map<std::size_t> rooms;    // joined rooms, with the index in each room's subscriber list
+
+    // Heartbeat state, in ticks of the hub's timer wheel.
+    Wheel_Entry timer;
+    bool upgraded = false;          // handshake done
+    std::uint64_t last_seen = 0;    // tick of the last read
+    std::uint64_t pinged_at = 0;    // tick of the last ping sent
+
+private:
+    static constexpr std::size_t max_gather = 64;
+
+    void write_queued();
+    void wait_writable();
+    void consume(std::size_t length);
+
+    tcp::socket socket_;
+    const Send_Queue_Options& options_;
+    std::deque<Shared_Frame> queue_;
+    std::size_t queued_bytes_ = 0;
+    std::size_t written_ = 0;       // of the first queued frame
+    bool waiting_ = false;          // for the socket to take more
+    bool finishing_ = false;
+    std::vector<boost::asio::const_buffer> buffers_;
+};
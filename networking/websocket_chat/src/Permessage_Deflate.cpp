@@ -0,0 +1,191 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Permessage_Deflate.h"
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+namespace {
+    // Output grows by at most this much per zlib call.
+    constexpr std::size_t output_chunk = 16 * 1024;
+
+    // What a sync flush ends with; dropped by the sender, put back by the receiver.
+    constexpr std::string_view flush_tail("\x00\x00\xff\xff", 4);
+
+    std::string_view trim(std::string_view value) {
+        while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+        while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+        return value;
+    }
+
+    // Cuts the next `separator`-delimited item off the front of `list`.
+    std::string_view next_item(std::string_view& list, char separator) {
+        std::size_t at = list.find(separator);
+        std::string_view item = trim(list.substr(0, at));
+        list = at == std::string_view::npos ? std::string_view() : list.substr(at + 1);
+        return item;
+    }
+
+    // 8..15, or 0 if the value is not a window size.
+    int window_bits(std::string_view value) {
+        if (value.size() >= 2 && value.front() == '"' && value.back() == '"') value = value.substr(1, value.size() - 2);
+        int bits = 0;
+        auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), bits);
+        if (ec != std::errc() || end != value.data() + value.size() || bits < 8 || bits > 15) return 0;
+        return bits;
+    }
+
+    // One offer: its parameters, or nothing if one is unknown, repeated or
+    // invalid, or the client wants a window zlib cannot produce (8 bits).
+    std::optional<Deflate_Params> accept_offer(std::string_view parameters, const Deflate_Options& options,
+                                               bool& window_offered) {
+        Deflate_Params params;
+        params.server_no_context_takeover = !options.context_takeover;
+        params.client_no_context_takeover = !options.context_takeover;
+        params.server_max_window_bits = options.max_window_bits;
+        window_offered = false;
+
+        bool seen[4] = {};
+        while (!parameters.empty()) {
+            std::string_view parameter = next_item(parameters, ';');
+            std::size_t equals = parameter.find('=');
+            std::string_view name = trim(parameter.substr(0, equals));
+            std::string_view value = equals == std::string_view::npos ? std::string_view() : trim(parameter.substr(equals + 1));
+            bool has_value = equals != std::string_view::npos;
+
+            int index = name == "server_no_context_takeover" ? 0 : name == "client_no_context_takeover" ? 1 :
+                        name == "server_max_window_bits" ? 2 : name == "client_max_window_bits" ? 3 : -1;
+            if (index < 0 || seen[index]) return std::nullopt;
+            seen[index] = true;
+
+            switch (index) {
+                case 0:
+                    if (has_value) return std::nullopt;
+                    params.server_no_context_takeover = true;
+                    break;
+                case 1:
+                    if (has_value) return std::nullopt;
+                    params.client_no_context_takeover = true;
+                    break;
+                case 2: {
+                    int bits = window_bits(value);
+                    if (bits < 9) return std::nullopt;
+                    params.server_max_window_bits = std::min(params.server_max_window_bits, bits);
+                    window_offered = true;
+                    break;
+                }
+                case 3:
+                    // Only says the client can limit its window; inflating with 15 bits takes any.
+                    if (has_value && window_bits(value) == 0) return std::nullopt;
+                    break;
+            }
+        }
+        return params;
+    }
+}
+
+std::optional<Deflate_Params> negotiate_deflate(std::string_view extensions, const Deflate_Options& options,
+                                                std::string& response) {
+    if (!options.enabled) return std::nullopt;
+
+    while (!extensions.empty()) {
+        std::string_view offer = next_item(extensions, ',');
+        std::string_view name = next_item(offer, ';');
+        if (name != "permessage-deflate") continue;
+
+        bool window_offered = false;
+        std::optional<Deflate_Params> params = accept_offer(offer, options, window_offered);
+        if (!params) continue;
+
+        response = "permessage-deflate";
+        if (params->server_no_context_takeover) response += "; server_no_context_takeover";
+        if (params->client_no_context_takeover) response += "; client_no_context_takeover";
+        if (window_offered || params->server_max_window_bits < 15) {
+            response += "; server_max_window_bits=" + std::to_string(params->server_max_window_bits);
+        }
+        return params;
+    }
+    return std::nullopt;
+}
+
+Deflate_Encoder::Deflate_Encoder(int level, int window_bits, bool context_takeover)
+    : context_takeover_(context_takeover)
+{
+    // Negative window bits: raw deflate, no zlib header or trailer.
+    if (deflateInit2(&stream_, level, Z_DEFLATED, -std::clamp(window_bits, 9, 15), 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("deflateInit2 failed");
+    }
+}
+
+Deflate_Encoder::~Deflate_Encoder() {
+    deflateEnd(&stream_);
+}
+
+void Deflate_Encoder::compress(std::string_view message, std::string& out) {
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(message.data()));
+    stream_.avail_in = static_cast<uInt>(message.size());
+
+    for (;;) {
+        std::size_t used = out.size();
+        std::size_t chunk = std::min<std::size_t>(output_chunk, deflateBound(&stream_, stream_.avail_in) + 16);
+        out.resize(used + chunk);
+        stream_.next_out = reinterpret_cast<Bytef*>(out.data() + used);
+        stream_.avail_out = static_cast<uInt>(chunk);
+
+        int result = deflate(&stream_, Z_SYNC_FLUSH);
+        out.resize(out.size() - stream_.avail_out);
+        if (result == Z_STREAM_ERROR) throw std::runtime_error("deflate failed");
+
+        // The flush is complete once deflate leaves output space unused.
+        if (stream_.avail_out != 0) break;
+    }
+    if (std::string_view(out).ends_with(flush_tail)) out.resize(out.size() - flush_tail.size());
+    if (!context_takeover_) deflateReset(&stream_);
+}
+
+Deflate_Decoder::Deflate_Decoder(bool context_takeover)
+    : context_takeover_(context_takeover)
+{
+    if (inflateInit2(&stream_, -15) != Z_OK) {
+        throw std::runtime_error("inflateInit2 failed");
+    }
+}
+
+Deflate_Decoder::~Deflate_Decoder() {
+    inflateEnd(&stream_);
+}
+
+Deflate_Decoder::Status Deflate_Decoder::decompress(std::string_view message, std::string& out, std::size_t max_size) {
+    out.clear();
+    Status status = inflate_into(message, out, max_size);
+    if (status == Status::Ok) status = inflate_into(flush_tail, out, max_size);
+    if (!context_takeover_ || status != Status::Ok) inflateReset(&stream_);
+    return status;
+}
+
+Deflate_Decoder::Status Deflate_Decoder::inflate_into(std::string_view input, std::string& out, std::size_t max_size) {
+    stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream_.avail_in = static_cast<uInt>(input.size());
+
+    for (;;) {
+        std::size_t used = out.size();
+        out.resize(used + output_chunk);
+        stream_.next_out = reinterpret_cast<Bytef*>(out.data() + used);
+        stream_.avail_out = static_cast<uInt>(output_chunk);
+
+        int result = inflate(&stream_, Z_SYNC_FLUSH);
+        out.resize(out.size() - stream_.avail_out);
+        if (result == Z_STREAM_END) {
+            // A final block: the sender ended its stream, the next message starts a new one.
+            inflateReset(&stream_);
+            if (stream_.avail_in == 0) return out.size() > max_size ? Status::Too_Big : Status::Ok;
+            continue;
+        }
+        if (result != Z_OK && result != Z_BUF_ERROR) return Status::Corrupt;
+        if (out.size() > max_size) return Status::Too_Big;
+        if (stream_.avail_in == 0 && stream_.avail_out != 0) return Status::Ok;
+        if (result == Z_BUF_ERROR && stream_.avail_out != 0) return Status::Corrupt;    // no progress possible
+    }
+}
@@ -0,0 +1,73 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <zlib.h>
+
+struct Deflate_Options {
+    bool enabled = true;
+    int level = 6;                          // zlib level
+    std::size_t min_size = 64;              // smaller messages are sent uncompressed
+    int max_window_bits = 15;               // of the server's compressor, 9..15
+    bool context_takeover = false;          // keep the LZ77 window across messages, per connection
+};
+
+// What one connection agreed on (RFC 7692, 7.1). Without context takeover
+// every message is compressed on its own, so a broadcast can be compressed
+// once for every client with the same window and the compressor and
+// decompressor need not outlive a message: the server uses one per thread.
+struct Deflate_Params {
+    bool server_no_context_takeover = true;
+    bool client_no_context_takeover = true;
+    int server_max_window_bits = 15;
+};
+
+// Picks the first offer in Sec-WebSocket-Extensions that the server can accept
+// and fills `response` with the extension to answer with; nothing if none fits
+// (or deflate is disabled), and the connection goes on uncompressed.
+std::optional<Deflate_Params> negotiate_deflate(std::string_view extensions, const Deflate_Options& options,
+                                                std::string& response);
+
+// Raw deflate of whole messages: each one ends with a sync flush whose
+// 00 00 FF FF tail is dropped, as the extension requires. Without context
+// takeover the stream is reset after every message.
+class Deflate_Encoder {
+public:
+    Deflate_Encoder(int level, int window_bits, bool context_takeover);
+    ~Deflate_Encoder();
+    Deflate_Encoder(const Deflate_Encoder&) = delete;
+    Deflate_Encoder& operator=(const Deflate_Encoder&) = delete;
+
+    void compress(std::string_view message, std::string& out);
+
+private:
+    z_stream stream_{};
+    bool context_takeover_;
+};
+
+// Inflates whole messages, the tail put back. A 15-bit window decodes what a
+// client compressed with any window size.
+class Deflate_Decoder {
+public:
+    explicit Deflate_Decoder(bool context_takeover);
+    ~Deflate_Decoder();
+    Deflate_Decoder(const Deflate_Decoder&) = delete;
+    Deflate_Decoder& operator=(const Deflate_Decoder&) = delete;
+
+    enum class Status { Ok, Too_Big, Corrupt };
+
+    // Replaces `out` with the message; stops past max_size.
+    Status decompress(std::string_view message, std::string& out, std::size_t max_size);
+
+private:
+    Status inflate_into(std::string_view input, std::string& out, std::size_t max_size);
+
+    z_stream stream_{};
+    bool context_takeover_;
+};
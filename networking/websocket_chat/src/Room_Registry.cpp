@@ -0,0 +1,106 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "Room_Registry.h"
+#include <algorithm>
+#include <tuple>
+#include "Client_Session.h"
+
+void Room_History::append(Shared_Broadcast message) {
+    if (options_.max_messages == 0) return;
+    if (ring_.empty()) ring_.resize(options_.max_messages);
+
+    std::size_t size = cost(*message);
+    if (size > options_.max_bytes) {
+        // Not kept; neither is anything before it, so the ring never has a gap in its numbers.
+        while (count_ > 0) drop_oldest();
+        return;
+    }
+    if (count_ == ring_.size()) drop_oldest();
+    while (count_ > 0 && bytes_ + size > options_.max_bytes) drop_oldest();
+
+    ring_[(first_ + count_) % ring_.size()] = std::move(message);
+    ++count_;
+    bytes_ += size;
+}
+
+void Room_History::replay(std::uint64_t from, std::vector<Shared_Broadcast>& out) const {
+    if (count_ == 0) return;
+    std::uint64_t oldest = ring_[first_]->sequence;
+    std::size_t skip = from > oldest ? static_cast<std::size_t>(std::min<std::uint64_t>(from - oldest, count_)) : 0;
+    for (std::size_t i = skip; i < count_; ++i) out.push_back(ring_[(first_ + i) % ring_.size()]);
+}
+
+std::size_t Room_History::cost(const Broadcast& message) {
+    std::size_t size = message.message.size();
+    if (message.plain) size += message.plain->size();
+    for (const Shared_Frame& frame : message.deflated) {
+        if (frame) size += frame->size();
+    }
+    return size;
+}
+
+void Room_History::drop_oldest() {
+    bytes_ -= cost(*ring_[first_]);
+    ring_[first_].reset();
+    first_ = (first_ + 1) % ring_.size();
+    --count_;
+}
+
+Room_Registry::Room_Registry(const Room_History_Options& history, std::size_t max_rooms)
+    : history_(history),
+      max_rooms_per_stripe_(std::max<std::size_t>(1, (max_rooms + stripe_count - 1) / stripe_count)) {}
+
+std::optional<std::uint64_t> Room_Registry::subscribe(std::string_view room, std::size_t hub,
+                                                      std::optional<std::uint64_t> from,
+                                                      std::vector<Shared_Broadcast>& replay) {
+    Stripe& s = stripe(room);
+    {
+        std::shared_lock<std::shared_mutex> lock(s.mutex);
+        auto it = s.rooms.find(room);
+        if (it != s.rooms.end()) return subscribe(it->second, hub, from, replay);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(s.mutex);
+    auto it = s.rooms.find(room);
+    if (it == s.rooms.end()) {
+        if (s.rooms.size() >= max_rooms_per_stripe_ && !drop_unsubscribed(s)) return std::nullopt;
+        it = s.rooms.emplace(std::piecewise_construct, std::forward_as_tuple(room), std::forward_as_tuple(history_)).first;
+    }
+    return subscribe(it->second, hub, from, replay);
+}
+
+std::uint64_t Room_Registry::subscribe(Room& room, std::size_t hub, std::optional<std::uint64_t> from,
+                                       std::vector<Shared_Broadcast>& replay) {
+    std::lock_guard<std::mutex> lock(room.mutex);
+    if (std::ranges::find(room.hubs, hub) == room.hubs.end()) room.hubs.push_back(hub);
+    if (from) room.history.replay(*from, replay);
+    return room.last_sequence;
+}
+
+void Room_Registry::remove(std::string_view room, std::size_t hub) {
+    Stripe& s = stripe(room);
+    std::unique_lock<std::shared_mutex> lock(s.mutex);
+    auto it = s.rooms.find(room);
+    if (it == s.rooms.end()) return;
+    std::erase(it->second.hubs, hub);
+    if (it->second.hubs.empty() && it->second.history.empty()) s.rooms.erase(it);
+}
+
+// Called with the stripe locked exclusively, so no room's mutex is held.
+bool Room_Registry::drop_unsubscribed(Stripe& s) {
+    auto it = std::ranges::find_if(s.rooms, [](const auto& entry) { return entry.second.hubs.empty(); });
+    if (it == s.rooms.end()) return false;
+    s.rooms.erase(it);
+    return true;
+}
+
+std::size_t Room_Registry::rooms() const {
+    std::size_t count = 0;
+    for (const Stripe& s : stripes_) {
+        std::shared_lock<std::shared_mutex> lock(s.mutex);
+        count += s.rooms.size();
+    }
+    return count;
+}
@@ -0,0 +1,143 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Defined in Client_Session.h.
+struct Broadcast;
+using Shared_Broadcast = std::shared_ptr<const Broadcast>;
+
+// Hashes std::string keys so they can be looked up by std::string_view without a copy.
+struct Room_Name_Hash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view name) const {
+        return std::hash<std::string_view>{}(name);
+    }
+};
+
+template <typename T>
+using Room_Map = std::unordered_map<std::string, T, Room_Name_Hash, std::equal_to<>>;
+
+struct Room_History_Options {
+    std::size_t max_messages = 64;                  // kept per room, 0: none; 64 replay in one gather write
+    std::size_t max_bytes = 256 * 1024;             // of frames and text kept per room
+};
+
+// A room's last messages, already encoded, in a ring of fixed size: the oldest
+// is overwritten when the ring is full or over its bytes. Sequence numbers are
+// consecutive, so a replay starts at an index, without a search.
+class Room_History {
+public:
+    explicit Room_History(const Room_History_Options& options)
+        : options_(options) {}
+
+    void append(Shared_Broadcast message);
+
+    // Appends the messages numbered `from` and after to `out`, oldest first.
+    void replay(std::uint64_t from, std::vector<Shared_Broadcast>& out) const;
+
+    bool empty() const {
+        return count_ == 0;
+    }
+
+private:
+    static std::size_t cost(const Broadcast& message);
+    void drop_oldest();
+
+    const Room_History_Options& options_;
+    std::vector<Shared_Broadcast> ring_;            // max_messages slots, allocated by the first message
+    std::size_t first_ = 0;                         // oldest
+    std::size_t count_ = 0;
+    std::size_t bytes_ = 0;
+};
+
+// Which threads (hubs) have subscribers in which room, and each room's
+// sequence numbers and history. Who exactly is subscribed is kept by each hub
+// for its own clients, touched by that thread only. Rooms are spread over
+// stripes, each with its own lock, taken shared for everything but creating
+// and removing a room, and every room has its own mutex for its hubs and its
+// history: joining, leaving and publishing contend only within a room, and
+// with the creation or removal of rooms in the same stripe. A room outlives
+// its subscribers as long as it has history; the number of rooms is bounded,
+// a full stripe makes room by dropping a room nobody is subscribed to.
+class Room_Registry {
+public:
+    Room_Registry(const Room_History_Options& history, std::size_t max_rooms);
+
+    // Registers the hub with the room, creating it; with `from`, appends the
+    // history from that sequence number on to `replay`. Returns the room's
+    // last sequence number, which everything in the history has and nothing
+    // published later will; nothing if the room cannot be created.
+    std::optional<std::uint64_t> subscribe(std::string_view room, std::size_t hub, std::optional<std::uint64_t> from,
+                                           std::vector<Shared_Broadcast>& replay);
+
+    // The hub lost its last subscriber to the room.
+    void remove(std::string_view room, std::size_t hub);
+
+    // Numbers the next message of an existing room, builds it with
+    // make(sequence), keeps it in the history and fills `hubs` with the hubs
+    // to deliver it to, all under the room's lock, so that a subscriber either
+    // finds the message in the history or gets it delivered. Nothing if there
+    // is no such room.
+    template <typename Make>
+    Shared_Broadcast publish(std::string_view room, Make&& make, std::vector<std::size_t>& hubs) {
+        hubs.clear();
+        Stripe& s = stripe(room);
+        std::shared_lock<std::shared_mutex> lock(s.mutex);
+        auto it = s.rooms.find(room);
+        if (it == s.rooms.end()) return nullptr;
+
+        Room& r = it->second;
+        std::lock_guard<std::mutex> room_lock(r.mutex);
+        Shared_Broadcast message = make(++r.last_sequence);
+        r.history.append(message);
+        hubs = r.hubs;
+        return message;
+    }
+
+    std::size_t rooms() const;
+
+private:
+    static constexpr std::size_t stripe_count = 64;
+
+    struct Room {
+        explicit Room(const Room_History_Options& options)
+            : history(options) {}
+
+        std::mutex mutex;
+        std::vector<std::size_t> hubs;              // with subscribers
+        std::uint64_t last_sequence = 0;
+        Room_History history;
+    };
+
+    struct Stripe {
+        Room_Map<Room> rooms;
+        mutable std::shared_mutex mutex;
+    };
+
+    static std::uint64_t subscribe(Room& room, std::size_t hub, std::optional<std::uint64_t> from,
+                                   std::vector<Shared_Broadcast>& replay);
+    static bool drop_unsubscribed(Stripe& s);
+
+    Stripe& stripe(std::string_view room) {
+        return stripes_[Room_Name_Hash{}(room) % stripe_count];
+    }
+
+    Room_History_Options history_;
+    std::size_t max_rooms_per_stripe_;
+    std::array<Stripe, stripe_count> stripes_;
+};
@@ -0,0 +1,90 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Where an object sits in a Timer_Wheel; a member of the object, so being
+// scheduled costs no allocation and cancelling is a swap-remove.
+struct Wheel_Entry {
+    static constexpr std::size_t unscheduled = static_cast<std::size_t>(-1);
+
+    std::uint64_t deadline = 0;                     // tick it expires at
+    std::size_t slot = unscheduled;
+    std::size_t index = 0;                          // in the slot
+};
+
+// Hashed timing wheel: deadlines are whole ticks, a deadline goes into slot
+// `deadline % slots`, and every tick only the slot of that tick is looked at.
+// Deadlines more than one turn ahead stay in their slot until their turn comes.
+// Scheduling and cancelling are O(1), a tick costs what is in its slot. Objects
+// of T have a `Wheel_Entry timer` member; the wheel holds plain pointers, so
+// an object must be cancelled before it goes away. One thread only.
+template <typename T>
+class Timer_Wheel {
+public:
+    explicit Timer_Wheel(std::size_t slots = 512)
+        : slots_(std::bit_ceil(std::max<std::size_t>(slots, 2))) {}
+
+    std::uint64_t now() const {
+        return now_;
+    }
+
+    // Reschedules if already scheduled; a deadline not after now expires next tick.
+    void schedule(T& object, std::uint64_t deadline) {
+        cancel(object);
+        Wheel_Entry& entry = object.timer;
+        entry.deadline = std::max(deadline, now_ + 1);
+        entry.slot = entry.deadline & (slots_.size() - 1);
+        entry.index = slots_[entry.slot].size();
+        slots_[entry.slot].push_back(&object);
+        ++size_;
+    }
+
+    void cancel(T& object) {
+        Wheel_Entry& entry = object.timer;
+        if (entry.slot == Wheel_Entry::unscheduled) return;
+        auto& slot = slots_[entry.slot];
+        if (entry.index + 1 != slot.size()) {
+            slot[entry.index] = slot.back();
+            slot[entry.index]->timer.index = entry.index;
+        }
+        slot.pop_back();
+        entry.slot = Wheel_Entry::unscheduled;
+        --size_;
+    }
+
+    // Moves to the next tick and calls expire(T&) for everything due in it,
+    // already unscheduled, so expire may schedule it again.
+    template <typename F>
+    void advance(F&& expire) {
+        ++now_;
+        auto& slot = slots_[now_ & (slots_.size() - 1)];
+        due_.clear();
+        for (std::size_t i = 0; i < slot.size();) {
+            if (slot[i]->timer.deadline > now_) {
+                ++i;
+                continue;
+            }
+            due_.push_back(slot[i]);
+            cancel(*slot[i]);               // swaps the last one into i
+        }
+        for (T* object : due_) expire(*object);
+    }
+
+    std::size_t size() const {
+        return size_;
+    }
+
+private:
+    std::vector<std::vector<T*>> slots_;
+    std::vector<T*> due_;
+    std::uint64_t now_ = 0;
+    std::size_t size_ = 0;
+};
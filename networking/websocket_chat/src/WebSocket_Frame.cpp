@@ -0,0 +1,229 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "WebSocket_Frame.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+std::vector<unsigned char> encode_frame(std::string_view payload, Opcode opcode, bool compressed) {
+    std::vector<unsigned char> out;
+    out.reserve(payload.size() + 10);
+    out.push_back(0x80 | (compressed ? 0x40 : 0) | static_cast<unsigned char>(opcode));
+    if (payload.size() < 126) {
+        out.push_back(static_cast<unsigned char>(payload.size()));
+    } else if (payload.size() <= 0xFFFF) {
+        out.push_back(126);
+        out.push_back((payload.size() >> 8) & 0xFF);
+        out.push_back(payload.size() & 0xFF);
+    } else {
+        out.push_back(127);
+        for (int shift = 56; shift >= 0; shift -= 8) out.push_back((static_cast<std::uint64_t>(payload.size()) >> shift) & 0xFF);
+    }
+    out.insert(out.end(), payload.begin(), payload.end());
+    return out;
+}
+
+std::vector<unsigned char> encode_close(std::uint16_t code) {
+    const char payload[2] = {static_cast<char>(code >> 8), static_cast<char>(code & 0xFF)};
+    return encode_frame({payload, 2}, Opcode::Close);
+}
+
+void unmask(unsigned char* data, std::size_t size, const std::array<unsigned char, 4>& key, std::size_t offset) {
+    // The key rotated to start at this offset; every wide step is a multiple of
+    // 4 bytes, so the same rotated key lines up for the whole run.
+    std::array<unsigned char, 4> rotated{};
+    for (std::size_t i = 0; i < 4; ++i) rotated[i] = key[(offset + i) & 3];
+    std::uint32_t key32;
+    std::memcpy(&key32, rotated.data(), 4);
+
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i key128 = _mm_set1_epi32(static_cast<int>(key32));
+    for (; i + 64 <= size; i += 64) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 16));
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 32));
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_xor_si128(a, key128));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i + 16), _mm_xor_si128(b, key128));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i + 32), _mm_xor_si128(c, key128));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i + 48), _mm_xor_si128(d, key128));
+    }
+    for (; i + 16 <= size; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i), _mm_xor_si128(a, key128));
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t key128 = vreinterpretq_u8_u32(vdupq_n_u32(key32));
+    for (; i + 16 <= size; i += 16) {
+        vst1q_u8(data + i, veorq_u8(vld1q_u8(data + i), key128));
+    }
+#endif
+    const std::uint64_t key64 = (static_cast<std::uint64_t>(key32) << 32) | key32;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        word ^= key64;
+        std::memcpy(data + i, &word, 8);
+    }
+    for (; i < size; ++i) data[i] ^= rotated[i & 3];
+}
+
+// Codes a peer may send (RFC 6455, 7.4): the defined ones except those that
+// must never be on the wire (1004 reserved, 1005, 1006, 1015), and 3000-4999.
+static bool valid_close_code(std::uint16_t code) {
+    return (code >= 1000 && code <= 1003) || (code >= 1007 && code <= 1014) || (code >= 3000 && code <= 4999);
+}
+
+std::uint16_t Frame_Decoder::close_code() const {
+    if (payload_.size() < 2) return 1005;
+    return static_cast<std::uint16_t>((static_cast<unsigned char>(payload_[0]) << 8) | static_cast<unsigned char>(payload_[1]));
+}
+
+Frame_Decoder::Status Frame_Decoder::next(unsigned char* data, std::size_t size, std::size_t& consumed) {
+    consumed = 0;
+    if (returned_) {
+        // A control frame may have come between fragments: the message stays.
+        if (!in_message_) message_.clear();
+        control_.clear();
+        payload_ = {};
+        returned_ = false;
+    }
+
+    for (;;) {
+        if (state_ == State::Error) return Status::Error;
+
+        if (state_ == State::Header) {
+            // 2 bytes, then the extended length and the masking key they announce.
+            std::size_t needed = 2;
+            for (;;) {
+                if (header_size_ >= 2) {
+                    std::size_t length = header_[1] & 0x7F;
+                    needed = 2 + (length == 126 ? 2 : length == 127 ? 8 : 0) + (header_[1] & 0x80 ? 4 : 0);
+                }
+                if (header_size_ == needed) break;
+                if (consumed == size) return Status::Incomplete;
+                header_[header_size_++] = data[consumed++];
+            }
+            if (parse_header() == Status::Error) return Status::Error;
+
+            direct_ = nullptr;
+            bool control = static_cast<unsigned char>(frame_opcode_) & 0x8;
+            if (!control && fin_ && frame_opcode_ != Opcode::Continuation && remaining_ <= size - consumed) {
+                direct_ = data + consumed;
+            }
+        }
+
+        std::size_t piece = static_cast<std::size_t>(std::min<std::uint64_t>(remaining_, size - consumed));
+        if (piece > 0) {
+            unsigned char* at = data + consumed;
+            unmask(at, piece, mask_, mask_offset_);
+            if (!direct_) {
+                std::string& target = static_cast<unsigned char>(frame_opcode_) & 0x8 ? control_ : message_;
+                target.append(reinterpret_cast<const char*>(at), piece);
+            }
+            mask_offset_ += piece;
+            remaining_ -= piece;
+            consumed += piece;
+        }
+        if (remaining_ > 0) return Status::Incomplete;
+
+        Status status = finish_frame();
+        if (status != Status::Incomplete) {
+            returned_ = true;
+            return status;
+        }
+    }
+}
+
+Frame_Decoder::Status Frame_Decoder::parse_header() {
+    fin_ = header_[0] & 0x80;
+    frame_opcode_ = static_cast<Opcode>(header_[0] & 0x0F);
+    // RSV1 marks a compressed message, on its first frame only (RFC 7692, 6).
+    bool first_data_frame = frame_opcode_ == Opcode::Text || frame_opcode_ == Opcode::Binary;
+    unsigned char allowed = allow_compressed_ && first_data_frame ? 0x40 : 0;
+    if (header_[0] & 0x70 & ~allowed) return fail(Close_Code::protocol_error, "reserved bits set");
+    if (!(header_[1] & 0x80)) return fail(Close_Code::protocol_error, "client frame not masked");
+
+    std::uint64_t length = header_[1] & 0x7F;
+    std::size_t at = 2;
+    if (length == 126) {
+        length = (static_cast<std::uint64_t>(header_[2]) << 8) | header_[3];
+        at = 4;
+    } else if (length == 127) {
+        length = 0;
+        for (std::size_t i = 2; i < 10; ++i) length = (length << 8) | header_[i];
+        if (length >> 63) return fail(Close_Code::protocol_error, "payload length over 63 bits");
+        at = 10;
+    }
+    std::copy_n(header_.begin() + static_cast<std::ptrdiff_t>(at), 4, mask_.begin());
+
+    switch (frame_opcode_) {
+        case Opcode::Continuation:
+            if (!in_message_) return fail(Close_Code::protocol_error, "continuation outside a message");
+            break;
+        case Opcode::Text:
+        case Opcode::Binary:
+            if (in_message_) return fail(Close_Code::protocol_error, "new message inside a fragmented one");
+            message_opcode_ = frame_opcode_;
+            message_compressed_ = header_[0] & 0x40;
+            in_message_ = true;
+            break;
+        case Opcode::Close:
+        case Opcode::Ping:
+        case Opcode::Pong:
+            if (!fin_) return fail(Close_Code::protocol_error, "fragmented control frame");
+            if (length > max_control_payload) return fail(Close_Code::protocol_error, "control frame over 125 bytes");
+            break;
+        default:
+            return fail(Close_Code::protocol_error, "unknown opcode");
+    }
+    if (!(static_cast<unsigned char>(frame_opcode_) & 0x8) && length > max_message_size_ - message_.size()) {
+        return fail(Close_Code::too_big, "message too big");
+    }
+
+    remaining_ = length;
+    frame_size_ = length;
+    mask_offset_ = 0;
+    header_size_ = 0;
+    state_ = State::Payload;
+    return Status::Incomplete;
+}
+
+Frame_Decoder::Status Frame_Decoder::finish_frame() {
+    state_ = State::Header;
+    switch (frame_opcode_) {
+        case Opcode::Close:
+            payload_ = control_;
+            if (payload_.size() == 1) return fail(Close_Code::protocol_error, "close payload of 1 byte");
+            if (payload_.size() >= 2 && !valid_close_code(close_code())) return fail(Close_Code::protocol_error, "invalid close code");
+            return Status::Close;
+        case Opcode::Ping:
+            payload_ = control_;
+            return Status::Ping;
+        case Opcode::Pong:
+            payload_ = control_;
+            return Status::Pong;
+        default:
+            break;
+    }
+    if (!fin_) return Status::Incomplete;
+
+    in_message_ = false;
+    payload_ = direct_ ? std::string_view(reinterpret_cast<const char*>(direct_), frame_size_) : std::string_view(message_);
+    return Status::Message;
+}
+
+Frame_Decoder::Status Frame_Decoder::fail(std::uint16_t code, const char* reason) {
+    state_ = State::Error;
+    error_code_ = code;
+    error_ = reason;
+    return Status::Error;
+}
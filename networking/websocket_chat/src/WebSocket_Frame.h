@@ -0,0 +1,132 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class Opcode : std::uint8_t {
+    Continuation = 0x0,
+    Text = 0x1,
+    Binary = 0x2,
+    Close = 0x8,
+    Ping = 0x9,
+    Pong = 0xA,
+};
+
+// Close status codes sent by the server (RFC 6455, 7.4.1).
+namespace Close_Code {
+    inline constexpr std::uint16_t normal = 1000;
+    inline constexpr std::uint16_t going_away = 1001;
+    inline constexpr std::uint16_t protocol_error = 1002;
+    inline constexpr std::uint16_t invalid_payload = 1007;
+    inline constexpr std::uint16_t policy_violation = 1008;
+    inline constexpr std::uint16_t too_big = 1009;
+}
+
+// A server frame (never masked): header and payload; `compressed` sets RSV1
+// for a payload deflated by permessage-deflate.
+std::vector<unsigned char> encode_frame(std::string_view payload, Opcode opcode = Opcode::Text, bool compressed = false);
+
+// A close frame carrying `code`, and no reason.
+std::vector<unsigned char> encode_close(std::uint16_t code);
+
+// XORs data with the masking key, starting `offset` bytes into the key's
+// cycle, so a payload can be unmasked piece by piece as it arrives. 16 bytes
+// per step with SSE2 (x86) or NEON (ARM), 8 bytes per step otherwise, scalar tail.
+void unmask(unsigned char* data, std::size_t size, const std::array<unsigned char, 4>& key, std::size_t offset = 0);
+
+// Incremental decoder of client frames. next() takes whatever has arrived and
+// keeps its state between reads, down to a header split in the middle: header
+// bytes are collected, payload bytes are unmasked in place as they come. A
+// message in one frame that arrived whole is returned as a view into the caller's
+// bytes; a message that is fragmented or split over reads is reassembled into
+// the decoder's buffer. Control frames (ping, pong, close) may come between the
+// fragments of a message and are returned on their own, for the connection to
+// answer, never mixed into the message.
+class Frame_Decoder {
+public:
+    enum class Status { Incomplete, Message, Ping, Pong, Close, Error };
+
+    static constexpr std::size_t max_control_payload = 125;
+
+    explicit Frame_Decoder(std::size_t max_message_size = 1024 * 1024)
+        : max_message_size_(max_message_size) {}
+
+    // Accepts RSV1 on messages once permessage-deflate is negotiated.
+    void allow_compressed(bool allow) {
+        allow_compressed_ = allow;
+    }
+
+    // Consumes from the front of data up to the end of the next complete
+    // message or control frame (its status is returned), or all of it (Incomplete).
+    Status next(unsigned char* data, std::size_t size, std::size_t& consumed);
+
+    // Of the last Message, Ping, Pong or Close; valid until the next call, and
+    // for a message in one frame only as long as the bytes passed in.
+    std::string_view payload() const {
+        return payload_;
+    }
+
+    // Text or Binary, for Message.
+    Opcode opcode() const {
+        return message_opcode_;
+    }
+
+    // For Message: the payload is deflated and has to be inflated first.
+    bool compressed() const {
+        return message_compressed_;
+    }
+
+    // For Close: the code the peer sent, 1005 (none) if it sent none. A close
+    // with a 1-byte payload or a code not allowed on the wire is an Error.
+    std::uint16_t close_code() const;
+
+    // For Error: the close code to answer with and why.
+    std::uint16_t error_code() const {
+        return error_code_;
+    }
+
+    const char* error() const {
+        return error_;
+    }
+
+private:
+    enum class State { Header, Payload, Error };
+
+    Status fail(std::uint16_t code, const char* reason);
+    Status parse_header();
+    Status finish_frame();
+
+private:
+    std::size_t max_message_size_;
+    bool allow_compressed_ = false;
+    State state_ = State::Header;
+
+    std::array<unsigned char, 14> header_{};
+    std::size_t header_size_ = 0;               // bytes of header_ received
+    bool fin_ = false;
+    Opcode frame_opcode_ = Opcode::Continuation;
+    std::array<unsigned char, 4> mask_{};
+    std::uint64_t frame_size_ = 0;              // payload bytes of the frame
+    std::uint64_t remaining_ = 0;               // of them still to come
+    std::size_t mask_offset_ = 0;               // payload bytes of the frame unmasked so far
+
+    bool in_message_ = false;                   // data frames without FIN seen
+    Opcode message_opcode_ = Opcode::Text;
+    bool message_compressed_ = false;
+    std::string message_;                       // reassembled payload
+    std::string control_;                       // payload of a control frame
+    const unsigned char* direct_ = nullptr;     // payload of a whole unfragmented frame in the caller's bytes
+
+    std::string_view payload_;
+    bool returned_ = false;                     // the previous call returned a payload, drop it
+    std::uint16_t error_code_ = 0;
+    const char* error_ = "";
+};
@@ -0,0 +1,581 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#include "WebSocket_Server.h"
+#include <boost/beast/core/detail/base64.hpp>
+#include <openssl/sha.h>
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <thread>
+#include "Log_Limiter.h"
+#include "WebSocket_Frame.h"
+
+using boost::asio::use_awaitable;
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+
+// Every read lands here; the decoder keeps partial frames itself, so the
+// buffer never grows whatever the size of the messages.
+static constexpr std::size_t receive_buffer_size = 16 * 1024;
+
+// Handshake request limit.
+static constexpr std::size_t max_handshake_size = 8192;
+
+// One tick of the hubs' timer wheels.
+static constexpr std::chrono::seconds heartbeat_tick{1};
+
+// Room names: 1 to 64 characters, no whitespace.
+static constexpr std::size_t max_room_name = 64;
+
+// Pause before accepting again when out of descriptors or memory.
+static constexpr auto accept_backoff = std::chrono::milliseconds(50);
+
+// Accept errors that last until something is freed; retrying them at once spins.
+static bool out_of_resources(const boost::system::error_code& ec) {
+    return ec == boost::system::errc::too_many_files_open ||
+           ec == boost::system::errc::too_many_files_open_in_system ||
+           ec == boost::system::errc::no_buffer_space ||
+           ec == boost::system::errc::not_enough_memory;
+}
+
+static bool valid_room_name(std::string_view room) {
+    return !room.empty() && room.size() <= max_room_name &&
+           std::ranges::none_of(room, [](char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; });
+}
+
+WebSocket_Server::WebSocket_Server(unsigned short port, const WebSocket_Options& options)
+    : options_(options),
+      rooms_(options_.history, options_.max_rooms),
+      ping_frame_(std::make_shared<const std::vector<unsigned char>>(encode_frame({}, Opcode::Ping)))
+{
+    tcp::endpoint endpoint(tcp::v4(), port);
+    for (std::size_t i = 0; i < options_.threads; ++i) {
+        auto& hub = *hubs_.emplace_back(std::make_unique<Hub>());
+        hub.index = i;
+        hub.acceptor.open(endpoint.protocol());
+        hub.acceptor.set_option(tcp::acceptor::reuse_address(true));
+        hub.acceptor.set_option(reuse_port(true));
+        hub.acceptor.bind(endpoint);
+        hub.acceptor.listen(boost::asio::socket_base::max_listen_connections);
+    }
+
+    std::cout << "Server start on port: " << port << " (" << options_.threads << " threads";
+    if (options_.deflate.enabled) std::cout << ", permessage-deflate";
+    std::cout << ")\n";
+}
+
+void WebSocket_Server::start() {
+    for (auto& hub : hubs_) {
+        boost::asio::co_spawn(hub->io, listen(*hub), boost::asio::detached);
+        if (options_.ping_interval > 0 || options_.idle_timeout > 0 || options_.close_timeout > 0) {
+            boost::asio::co_spawn(hub->io, heartbeat(*hub), boost::asio::detached);
+        }
+    }
+
+    std::vector<std::thread> threads;
+    for (auto& hub : hubs_) {
+        threads.emplace_back([&hub]() { hub->io.run(); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void WebSocket_Server::stop() {
+    for (auto& hub : hubs_) {
+        hub->io.stop();
+    }
+}
+
+awaitable<void> WebSocket_Server::listen(Hub& hub) {
+    for (;;) {
+        boost::system::error_code ec;
+        tcp::socket socket = co_await hub.acceptor.async_accept(boost::asio::redirect_error(use_awaitable, ec));
+        if (ec) {
+            LOG_RATE_LIMITED(logger, 10, 10, "Accept error: {}", ec.message());
+            if (out_of_resources(ec)) {
+                boost::asio::steady_timer backoff(hub.io, accept_backoff);
+                co_await backoff.async_wait(boost::asio::redirect_error(use_awaitable, ec));
+            }
+            continue;
+        }
+        boost::asio::co_spawn(hub.io, handle_client(hub, std::move(socket)), boost::asio::detached);
+    }
+}
+
+awaitable<void> WebSocket_Server::handle_client(Hub& hub, tcp::socket socket) {
+    auto client = std::make_shared<Client_Session>(std::move(socket), options_.send_queue);
+    // The handshake is held to the idle timeout as well.
+    client->last_seen = hub.wheel.now();
+    schedule_check(hub, *client);
+    try {
+        std::string pending;
+        if (co_await handle_handshake(*client, pending)) {
+            client->slot = hub.clients.size();
+            hub.clients.push_back(client);
+            ++client_count_;
+            count_deflate(*client, 1);
+            client->upgraded = true;
+            client->last_seen = hub.wheel.now();
+            schedule_check(hub, *client);
+            LOG_RATE_LIMITED(logger, 100, 200, "Handshake complete. Client count: {}", client_count_.load());
+
+            co_await handle_frames(hub, *client, pending);
+        }
+    } catch (std::exception& e) {
+        LOG_RATE_LIMITED(logger, 100, 200, "Client error: {}", e.what());
+        client->close();
+    }
+
+    leave_all(hub, *client);
+    if (client->slot < hub.clients.size() && hub.clients[client->slot] == client) {
+        hub.clients.back()->slot = client->slot;
+        hub.clients[client->slot] = std::move(hub.clients.back());
+        hub.clients.pop_back();
+        --client_count_;
+        count_deflate(*client, -1);
+        LOG_RATE_LIMITED(logger, 100, 200, "Client disconnected. Client count: {}", client_count_.load());
+    }
+
+    // Sent a close it does not read, a client would keep the session and its
+    // queue for good: it is closed when close_timeout runs out.
+    if (client->finishing() && client->socket().is_open() && options_.close_timeout > 0) {
+        client->slot = hub.closing.size();
+        hub.closing.push_back(client);
+        hub.wheel.schedule(*client, hub.wheel.now() + options_.close_timeout + 1);
+    } else {
+        hub.wheel.cancel(*client);
+    }
+}
+
+// Bytes the client sent after the request are left in `pending`. A
+// permessage-deflate offer the server can accept is answered and recorded on
+// the client, with its own compressor and decompressor if it keeps a context.
+awaitable<bool> WebSocket_Server::handle_handshake(Client_Session& client, std::string& pending) {
+    tcp::socket& socket = client.socket();
+    std::string data;
+    std::size_t length = co_await boost::asio::async_read_until(
+        socket, boost::asio::dynamic_buffer(data, max_handshake_size), "\r\n\r\n", use_awaitable);
+
+    std::string request = data.substr(0, length);
+    pending = data.substr(length);
+
+    if (request.find("Upgrade: websocket") == std::string::npos) {
+        LOG_RATE_LIMITED(logger, 10, 10, "Not a WebSocket request");
+        co_return false;
+    }
+
+    std::string key;
+    std::string extensions;
+    std::istringstream stream(request);
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.starts_with("Sec-WebSocket-Key:")) {
+            key = line.substr(18);
+            key.erase(std::ranges::remove_if(key, ::isspace).begin(), key.end());
+        } else if (line.starts_with("Sec-WebSocket-Extensions:")) {
+            // The header may be repeated; the values form one list.
+            if (!extensions.empty()) extensions += ',';
+            extensions += line.substr(25);
+        }
+    }
+
+    if (key.empty()) {
+        LOG_RATE_LIMITED(logger, 10, 10, "Missing Sec-WebSocket-Key");
+        co_return false;
+    }
+
+    std::string accept_key = generate_accept_key(key);
+
+    std::string extension;
+    client.deflate = negotiate_deflate(extensions, options_.deflate, extension);
+    if (client.deflate) {
+        if (!client.deflate->server_no_context_takeover) {
+            client.encoder = std::make_unique<Deflate_Encoder>(
+                options_.deflate.level, client.deflate->server_max_window_bits, true);
+        }
+        if (!client.deflate->client_no_context_takeover) {
+            client.decoder = std::make_unique<Deflate_Decoder>(true);
+        }
+    }
+
+    std::ostringstream response;
+    response << "HTTP/1.1 101 Switching Protocols\r\n"
+             << "Upgrade: websocket\r\n"
+             << "Connection: Upgrade\r\n"
+             << "Sec-WebSocket-Accept: " << accept_key << "\r\n";
+    if (client.deflate) response << "Sec-WebSocket-Extensions: " << extension << "\r\n";
+    response << "\r\n";
+
+    co_await boost::asio::async_write(socket, boost::asio::buffer(response.str()), use_awaitable);
+    co_return true;
+}
+
+// Each read is handed to the decoder as it is; every message it completes is
+// broadcast (inflated first if it came compressed), pings are answered with a
+// pong, and a close or a protocol error is answered with a close frame, after
+// which the connection ends once its queue is written.
+awaitable<void> WebSocket_Server::handle_frames(Hub& hub, Client_Session& client, const std::string& pending) {
+    Frame_Decoder decoder(options_.max_message_size);
+    decoder.allow_compressed(client.deflate.has_value());
+    Deflate_Decoder& inflater = client.decoder ? *client.decoder : hub.inflater;
+    std::string inflated;
+    std::vector<unsigned char> buffer(std::max(receive_buffer_size, pending.size()));
+    std::size_t size = pending.size();
+    std::copy(pending.begin(), pending.end(), buffer.begin());
+
+    for (;;) {
+        if (size == 0) size = co_await client.socket().async_read_some(boost::asio::buffer(buffer), use_awaitable);
+        client.last_seen = hub.wheel.now();         // all the heartbeat costs per read
+
+        unsigned char* data = buffer.data();
+        while (size > 0) {
+            std::size_t consumed = 0;
+            Frame_Decoder::Status status = decoder.next(data, size, consumed);
+            data += consumed;
+            size -= consumed;
+
+            switch (status) {
+                case Frame_Decoder::Status::Incomplete:
+                case Frame_Decoder::Status::Pong:
+                    break;
+                case Frame_Decoder::Status::Message: {
+                    std::string_view payload = decoder.payload();
+                    if (decoder.compressed()) {
+                        Deflate_Decoder::Status inflate_status = inflater.decompress(payload, inflated, options_.max_message_size);
+                        if (inflate_status != Deflate_Decoder::Status::Ok) {
+                            bool too_big = inflate_status == Deflate_Decoder::Status::Too_Big;
+                            LOG_RATE_LIMITED(logger, 10, 10, "Closing client: {}", too_big ? "message too big" : "corrupt deflate data");
+                            client.send(std::make_shared<const std::vector<unsigned char>>(
+                                encode_close(too_big ? Close_Code::too_big : Close_Code::invalid_payload)));
+                            client.finish();
+                            co_return;
+                        }
+                        payload = inflated;
+                    }
+                    handle_message(hub, client, payload);
+                    break;
+                }
+                case Frame_Decoder::Status::Ping:
+                    client.send(std::make_shared<const std::vector<unsigned char>>(encode_frame(decoder.payload(), Opcode::Pong)));
+                    break;
+                case Frame_Decoder::Status::Close:
+                    client.send(std::make_shared<const std::vector<unsigned char>>(encode_close(Close_Code::normal)));
+                    client.finish();
+                    co_return;
+                case Frame_Decoder::Status::Error:
+                    LOG_RATE_LIMITED(logger, 10, 10, "Closing client: {}", decoder.error());
+                    client.send(std::make_shared<const std::vector<unsigned char>>(encode_close(decoder.error_code())));
+                    client.finish();
+                    co_return;
+            }
+        }
+    }
+}
+
+// Every hub ticks its wheel once a second with a single timer; a tick looks at
+// the clients due in it and nobody else, however many are connected.
+awaitable<void> WebSocket_Server::heartbeat(Hub& hub) {
+    boost::asio::steady_timer timer(hub.io);
+    auto next = std::chrono::steady_clock::now();
+    for (;;) {
+        next += heartbeat_tick;
+        timer.expires_at(next);
+        co_await timer.async_wait(use_awaitable);
+        hub.wheel.advance([this, &hub](Client_Session& client) { check_alive(hub, client); });
+    }
+}
+
+// A client is looked at when it is due a ping or due to be closed, as of its
+// last read; one that has read since is only rescheduled. Silent for
+// ping_interval, it gets a ping (again every ping_interval); silent for
+// idle_timeout, or still in the handshake by then, it is closed, and its
+// coroutine ends and frees it right away. One still finishing (its close
+// frame not yet written) is closed, and freed if its reader is done.
+void WebSocket_Server::check_alive(Hub& hub, Client_Session& client) {
+    if (client.finishing()) {
+        LOG_RATE_LIMITED(logger, 10, 10, "Closing a client that did not take its close frame");
+        client.close();
+        if (client.slot < hub.closing.size() && hub.closing[client.slot].get() == &client) {
+            hub.closing.back()->slot = client.slot;
+            hub.closing[client.slot] = std::move(hub.closing.back());
+            hub.closing.pop_back();                 // may free the client
+        }
+        return;
+    }
+
+    std::uint64_t now = hub.wheel.now();
+    if ((options_.idle_timeout > 0 && now > client.last_seen + options_.idle_timeout) || !client.upgraded) {
+        LOG_RATE_LIMITED(logger, 10, 10, "Closing idle client");
+        client.close();
+        return;
+    }
+    if (options_.ping_interval > 0 && now >= std::max(client.last_seen, client.pinged_at) + options_.ping_interval) {
+        client.send(ping_frame_);
+        client.pinged_at = now;
+    }
+    schedule_check(hub, client);
+}
+
+void WebSocket_Server::schedule_check(Hub& hub, Client_Session& client) {
+    std::uint64_t next = std::numeric_limits<std::uint64_t>::max();
+    // The tick of the last read may have begun up to a tick earlier: one more
+    // makes sure nobody is closed before idle_timeout of silence.
+    if (options_.idle_timeout > 0) next = client.last_seen + options_.idle_timeout + 1;
+    if (options_.ping_interval > 0 && client.upgraded) {
+        next = std::min(next, std::max(client.last_seen, client.pinged_at) + options_.ping_interval);
+    }
+    if (next != std::numeric_limits<std::uint64_t>::max()) hub.wheel.schedule(client, next);
+}
+
+// A plain message goes to everybody; a command manages the client's rooms or
+// publishes to one, and gets a reply only if it fails.
+void WebSocket_Server::handle_message(Hub& hub, Client_Session& client, std::string_view message) {
+    if (!message.starts_with('/')) {
+        std::string text = "Server got: ";
+        text += message;
+        broadcast(hub, text);
+        return;
+    }
+
+    std::size_t space = message.find(' ');
+    std::string_view command = message.substr(0, space);
+    std::string_view rest = space == std::string_view::npos ? std::string_view() : message.substr(space + 1);
+
+    if (command == "/join") {
+        // "/join ROOM" or "/join ROOM SEQ", SEQ the first message of the history to replay.
+        std::size_t sequence_start = rest.find(' ');
+        std::string_view room = rest.substr(0, sequence_start);
+        std::optional<std::uint64_t> from;
+        if (sequence_start != std::string_view::npos) {
+            std::string_view number = rest.substr(sequence_start + 1);
+            std::uint64_t sequence = 0;
+            auto [end, ec] = std::from_chars(number.data(), number.data() + number.size(), sequence);
+            if (ec != std::errc() || end != number.data() + number.size()) {
+                reply(client, "Usage: /join ROOM [SEQ]");
+                return;
+            }
+            from = sequence;
+        }
+        if (!valid_room_name(room)) {
+            reply(client, "Invalid room name");
+        } else if (!join(hub, client, room, from)) {
+            reply(client, "Too many rooms");
+        }
+    } else if (command == "/leave") {
+        if (!valid_room_name(rest)) {
+            reply(client, "Invalid room name");
+        } else {
+            leave(hub, client, rest);
+        }
+    } else if (command == "/to") {
+        std::size_t text_start = rest.find(' ');
+        std::string_view room = rest.substr(0, text_start);
+        if (!valid_room_name(room) || text_start == std::string_view::npos) {
+            reply(client, "Usage: /to ROOM TEXT");
+            return;
+        }
+        publish(hub, room, rest.substr(text_start + 1));
+    } else {
+        reply(client, "Unknown command");
+    }
+}
+
+// The room's subscriber list on this hub gets the client, and the registry
+// the hub. Asked for history, the client gets the messages the room kept from
+// `from` on, queued as one batch so they leave in one gather write, ahead of
+// anything published after; the room's last number as of now keeps those
+// already replayed from being delivered again.
+bool WebSocket_Server::join(Hub& hub, Client_Session& client, std::string_view room, std::optional<std::uint64_t> from) {
+    if (client.rooms.contains(room)) return true;
+    if (client.rooms.size() >= options_.max_rooms_per_client) return false;
+
+    hub.replay.clear();
+    std::optional<std::uint64_t> last_sequence = rooms_.subscribe(room, hub.index, from, hub.replay);
+    if (!last_sequence) return false;
+
+    auto it = hub.rooms.find(room);
+    if (it == hub.rooms.end()) it = hub.rooms.emplace(std::string(room), std::vector<Room_Subscriber>()).first;
+    client.rooms.emplace(std::string(room), it->second.size());
+    it->second.push_back({client.shared_from_this(), *last_sequence});
+
+    if (!hub.replay.empty()) {
+        hub.replay_frames.clear();
+        for (const Shared_Broadcast& message : hub.replay) hub.replay_frames.push_back(frame_for(client, *message));
+        if (!client.send(hub.replay_frames)) overflow(client);
+    }
+    return true;
+}
+
+// Swap-removes the client from the room's list, the last subscriber on a hub
+// unregisters it.
+bool WebSocket_Server::leave(Hub& hub, Client_Session& client, std::string_view room) {
+    auto joined = client.rooms.find(room);
+    if (joined == client.rooms.end()) return false;
+    std::size_t slot = joined->second;
+    client.rooms.erase(joined);
+
+    auto it = hub.rooms.find(room);
+    auto& subscribers = it->second;
+    if (slot + 1 != subscribers.size()) {
+        subscribers.back().client->rooms.find(room)->second = slot;
+        subscribers[slot] = std::move(subscribers.back());
+    }
+    subscribers.pop_back();
+    if (subscribers.empty()) {
+        hub.rooms.erase(it);
+        rooms_.remove(room, hub.index);
+    }
+    return true;
+}
+
+void WebSocket_Server::leave_all(Hub& hub, Client_Session& client) {
+    while (!client.rooms.empty()) {
+        std::string room = client.rooms.begin()->first;
+        leave(hub, client, room);
+    }
+}
+
+void WebSocket_Server::reply(Client_Session& client, std::string_view text) {
+    client.send(std::make_shared<const std::vector<unsigned char>>(encode_frame(text)));
+}
+
+// The message is encoded into one frame that every recipient's queue
+// references, so N recipients cost one encode and N reference counts, not N
+// copies. Compression works the same way: without context takeover a
+// compressed message depends on nothing but the window size, so it is
+// deflated once per window size that clients use, not once per client. The
+// sender's own thread delivers right away, every other thread gets one posted
+// handler sharing the frames. Nothing here waits for a socket.
+void WebSocket_Server::broadcast(Hub& from, std::string_view message) {
+    Shared_Broadcast frames = prepare(from, message);
+    for (auto& hub : hubs_) {
+        if (hub.get() == &from) continue;
+        boost::asio::post(hub->io, [this, &hub = *hub, frames]() { deliver(hub.clients, frames); });
+    }
+    deliver(from.clients, frames);
+}
+
+// Like broadcast(), but only the hubs the registry lists for the room get a
+// handler, and each delivers to its own subscribers of the room: the cost is
+// the room's size, not the server's. The message is numbered, sent as
+// "[ROOM:SEQ] TEXT", and kept in the room's history as encoded.
+void WebSocket_Server::publish(Hub& from, std::string_view room, std::string_view message) {
+    Shared_Broadcast frames = rooms_.publish(room, [&](std::uint64_t sequence) {
+        std::string text = "[";
+        text += room;
+        text += ':';
+        text += std::to_string(sequence);
+        text += "] ";
+        text += message;
+        return prepare(from, text, sequence);
+    }, from.room_hubs);
+    if (!frames) return;
+
+    for (std::size_t index : from.room_hubs) {
+        if (index == from.index) continue;
+        boost::asio::post(hubs_[index]->io, [this, &hub = *hubs_[index], room = std::string(room), frames]() {
+            deliver_room(hub, room, frames);
+        });
+    }
+    if (std::ranges::find(from.room_hubs, from.index) != from.room_hubs.end()) deliver_room(from, room, frames);
+}
+
+void WebSocket_Server::deliver_room(Hub& hub, std::string_view room, const Shared_Broadcast& message) {
+    auto it = hub.rooms.find(room);
+    if (it == hub.rooms.end()) return;
+    for (Room_Subscriber& subscriber : it->second) {
+        if (message->sequence <= subscriber.joined_at) continue;            // replayed when it joined
+        if (!subscriber.client->send(frame_for(*subscriber.client, *message))) overflow(*subscriber.client);
+    }
+}
+
+// Encodes and compresses the message for every kind of recipient.
+Shared_Broadcast WebSocket_Server::prepare(Hub& from, std::string_view message, std::uint64_t sequence) {
+    auto shared = std::make_shared<Broadcast>();
+    shared->message = message;
+    shared->sequence = sequence;
+
+    int deflated_clients = 0;
+    if (options_.deflate.enabled && message.size() >= options_.deflate.min_size) {
+        std::string compressed;
+        for (std::size_t bits = 9; bits < window_sizes; ++bits) {
+            int clients = shared_deflate_clients_[bits].load(std::memory_order_relaxed);
+            if (clients == 0) continue;
+
+            auto& encoder = from.encoders[bits];
+            if (!encoder) encoder = std::make_unique<Deflate_Encoder>(options_.deflate.level, static_cast<int>(bits), false);
+            compressed.clear();
+            encoder->compress(message, compressed);
+            shared->deflated[bits] = std::make_shared<const std::vector<unsigned char>>(encode_frame(compressed, Opcode::Text, true));
+            deflated_clients += clients;
+        }
+    }
+    if (client_count_.load(std::memory_order_relaxed) > deflated_clients) {
+        shared->plain = std::make_shared<const std::vector<unsigned char>>(encode_frame(message));
+    }
+
+    return shared;
+}
+
+void WebSocket_Server::deliver(const std::vector<std::shared_ptr<Client_Session>>& clients, const Shared_Broadcast& message) {
+    for (auto& client : clients) {
+        if (!client->send(frame_for(*client, *message))) overflow(*client);
+    }
+}
+
+void WebSocket_Server::overflow(Client_Session& client) {
+    if (options_.overflow == Overflow_Policy::Disconnect) {
+        LOG_RATE_LIMITED(logger, 1, 10, "Send queue full, disconnecting client");
+        client.close();
+    } else if (client.encoder) {
+        // The dropped frame already went through the client's compression
+        // context, so nothing compressed after it would inflate.
+        LOG_RATE_LIMITED(logger, 1, 10, "Send queue full, closing a client compressing with context takeover");
+        client.finish(std::make_shared<const std::vector<unsigned char>>(encode_close(Close_Code::policy_violation)));
+    } else {
+        LOG_RATE_LIMITED(logger, 1, 10, "Send queue full, message dropped for a client");
+    }
+}
+
+// The shared deflated frame for the client's window, its own compression if it
+// keeps a context, else the plain frame (also for a client that connected after
+// the frames were built).
+Shared_Frame WebSocket_Server::frame_for(Client_Session& client, const Broadcast& message) const {
+    if (client.deflate && message.message.size() >= options_.deflate.min_size) {
+        if (client.encoder) {
+            std::string compressed;
+            client.encoder->compress(message.message, compressed);
+            return std::make_shared<const std::vector<unsigned char>>(encode_frame(compressed, Opcode::Text, true));
+        }
+        if (const Shared_Frame& frame = message.deflated[client.deflate->server_max_window_bits]) return frame;
+    }
+    if (message.plain) return message.plain;
+    return std::make_shared<const std::vector<unsigned char>>(encode_frame(message.message));
+}
+
+void WebSocket_Server::count_deflate(const Client_Session& client, int delta) {
+    if (client.deflate && !client.encoder) {
+        shared_deflate_clients_[client.deflate->server_max_window_bits].fetch_add(delta, std::memory_order_relaxed);
+    }
+}
+
+std::string WebSocket_Server::generate_accept_key(const std::string& client_key) {
+    static const std::string magic = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    std::string combined = client_key + magic;
+
+    unsigned char hash[SHA_DIGEST_LENGTH];
+    SHA1(reinterpret_cast<const unsigned char*>(combined.c_str()), combined.size(), hash);
+
+    std::size_t encoded_size = boost::beast::detail::base64::encoded_size(SHA_DIGEST_LENGTH);
+
+    std::string encoded(encoded_size, '\0');
+    boost::beast::detail::base64::encode(&encoded[0], hash, SHA_DIGEST_LENGTH);
+
+    return encoded;
+}
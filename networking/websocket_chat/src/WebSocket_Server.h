@@ -0,0 +1,118 @@
+//
+// Created by Marat on 19.10.26.
+//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <boost/asio.hpp>
+#include "Client_Session.h"
+#include "Logger.h"
+
+// Defined in main.cpp.
+extern Logger logger;
+
+using boost::asio::awaitable;
+
+// What happens to a client whose outbound queue cannot take another message.
+enum class Overflow_Policy {
+    Drop,           // the message is skipped for that client, the others still get it
+    Disconnect      // the client is closed
+};
+
+struct WebSocket_Options {
+    std::size_t threads = 1;                        // one io_context and one SO_REUSEPORT acceptor each
+    Send_Queue_Options send_queue;
+    Overflow_Policy overflow = Overflow_Policy::Drop;
+    std::size_t max_message_size = 1024 * 1024;     // reassembled, larger messages close the connection (1009)
+    Deflate_Options deflate;                        // permessage-deflate
+    std::size_t max_rooms_per_client = 64;
+    std::size_t max_rooms = 100000;                 // rooms kept, with subscribers or only history
+    Room_History_Options history;                   // of every room, replayed to a joiner that asks
+    std::size_t ping_interval = 30;                 // seconds of silence before the server pings, 0: never
+    std::size_t idle_timeout = 60;                  // seconds of silence (or of handshake) before closing, 0: never
+    std::size_t close_timeout = 5;                  // seconds a closing client has to take what is queued, 0: forever
+};
+
+// Chat server: every message a client sends is broadcast to every client,
+// unless it is a command: "/join ROOM [SEQ]" and "/leave ROOM" subscribe and
+// unsubscribe, "/to ROOM TEXT" publishes to the room's subscribers only. Room
+// messages are numbered, and a joiner that gives a number gets the room's
+// history from that message on before anything new.
+// Every thread runs its own io_context with its own SO_REUSEPORT acceptor and
+// the clients it accepted, each a coroutine reading frames and a Client_Session
+// holding its outbound queue. Control frames are answered here, only data
+// messages reach the chat. Clients that negotiate permessage-deflate without
+// context takeover share one compressed frame per window size. A hub keeps the
+// subscriber lists of its own clients; the shared Room_Registry only says
+// which hubs a room has subscribers on. Heartbeats and idle timeouts run off
+// one timer wheel per hub, ticked by a single timer.
+class WebSocket_Server {
+public:
+    WebSocket_Server(unsigned short port, const WebSocket_Options& options = {});
+    void start();
+    void stop();                                    // start() returns once every thread has stopped
+
+private:
+    static constexpr std::size_t window_sizes = Broadcast::window_sizes;
+
+    // A client in a room's list on its hub, and the room's last message when it
+    // joined: that one and those before are replayed or not at all, never live.
+    struct Room_Subscriber {
+        std::shared_ptr<Client_Session> client;
+        std::uint64_t joined_at = 0;
+    };
+
+    // One event loop thread and the clients it accepted.
+    struct Hub {
+        std::size_t index = 0;                      // in hubs_
+        boost::asio::io_context io{1};
+        tcp::acceptor acceptor{io};
+        std::vector<std::shared_ptr<Client_Session>> clients;
+        std::vector<std::shared_ptr<Client_Session>> closing;   // reader done, close frame not yet taken
+        std::array<std::unique_ptr<Deflate_Encoder>, window_sizes> encoders;    // created on first use
+        Deflate_Decoder inflater{false};            // for every client without context takeover
+        Room_Map<std::vector<Room_Subscriber>> rooms;                           // subscribers on this hub
+        std::vector<std::size_t> room_hubs;         // scratch for a publish
+        std::vector<Shared_Broadcast> replay;       // scratch for a join
+        std::vector<Shared_Frame> replay_frames;
+        Timer_Wheel<Client_Session> wheel;          // a tick per second
+    };
+
+    awaitable<void> listen(Hub& hub);
+    awaitable<void> heartbeat(Hub& hub);
+    void check_alive(Hub& hub, Client_Session& client);
+    void schedule_check(Hub& hub, Client_Session& client);
+    awaitable<void> handle_client(Hub& hub, tcp::socket socket);
+    awaitable<bool> handle_handshake(Client_Session& client, std::string& pending);
+    awaitable<void> handle_frames(Hub& hub, Client_Session& client, const std::string& pending);
+    void handle_message(Hub& hub, Client_Session& client, std::string_view message);
+    bool join(Hub& hub, Client_Session& client, std::string_view room, std::optional<std::uint64_t> from);
+    bool leave(Hub& hub, Client_Session& client, std::string_view room);
+    void leave_all(Hub& hub, Client_Session& client);
+    Shared_Broadcast prepare(Hub& from, std::string_view message, std::uint64_t sequence = 0);
+    void broadcast(Hub& from, std::string_view message);
+    void publish(Hub& from, std::string_view room, std::string_view message);
+    void deliver_room(Hub& hub, std::string_view room, const Shared_Broadcast& message);
+    void deliver(const std::vector<std::shared_ptr<Client_Session>>& clients, const Shared_Broadcast& message);
+    void overflow(Client_Session& client);
+    static void reply(Client_Session& client, std::string_view text);
+    Shared_Frame frame_for(Client_Session& client, const Broadcast& message) const;
+    void count_deflate(const Client_Session& client, int delta);
+    static std::string generate_accept_key(const std::string& client_key);
+
+private:
+    WebSocket_Options options_;
+    std::vector<std::unique_ptr<Hub>> hubs_;
+    std::atomic<int> client_count_{0};
+    std::array<std::atomic<int>, window_sizes> shared_deflate_clients_{};    // by window bits, without context takeover
+    Room_Registry rooms_;
+    Shared_Frame ping_frame_;
+};
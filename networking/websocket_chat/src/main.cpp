@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "WebSocket_Server.h"
+
+Logger logger(Logger::Mode::Text, std::cout);
+
+int main(int argc, char* argv[]) {
+    WebSocket_Options options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = std::max(1ul, std::stoul(argv[++i]));
+        } else if (arg == "--max-queue" && i + 1 < argc) {
+            options.send_queue.max_messages = std::max(1ul, std::stoul(argv[++i]));
+        } else if (arg == "--max-queue-bytes" && i + 1 < argc) {
+            options.send_queue.max_bytes = std::stoul(argv[++i]);
+        } else if (arg == "--overflow" && i + 1 < argc && (std::string(argv[i + 1]) == "drop" || std::string(argv[i + 1]) == "disconnect")) {
+            options.overflow = std::string(argv[++i]) == "drop" ? Overflow_Policy::Drop : Overflow_Policy::Disconnect;
+        } else if (arg == "--max-message" && i + 1 < argc) {
+            options.max_message_size = std::stoul(argv[++i]);
+        } else if (arg == "--no-deflate") {
+            options.deflate.enabled = false;
+        } else if (arg == "--deflate-level" && i + 1 < argc) {
+            options.deflate.level = std::clamp(std::stoi(argv[++i]), 1, 9);
+        } else if (arg == "--deflate-min-size" && i + 1 < argc) {
+            options.deflate.min_size = std::stoul(argv[++i]);
+        } else if (arg == "--deflate-window-bits" && i + 1 < argc) {
+            options.deflate.max_window_bits = std::clamp(std::stoi(argv[++i]), 9, 15);
+        } else if (arg == "--deflate-context-takeover") {
+            options.deflate.context_takeover = true;
+        } else if (arg == "--history" && i + 1 < argc) {
+            options.history.max_messages = std::stoul(argv[++i]);
+        } else if (arg == "--history-bytes" && i + 1 < argc) {
+            options.history.max_bytes = std::stoul(argv[++i]);
+        } else if (arg == "--max-rooms" && i + 1 < argc) {
+            options.max_rooms = std::max(1ul, std::stoul(argv[++i]));
+        } else if (arg == "--ping-interval" && i + 1 < argc) {
+            options.ping_interval = std::stoul(argv[++i]);
+        } else if (arg == "--idle-timeout" && i + 1 < argc) {
+            options.idle_timeout = std::stoul(argv[++i]);
+        } else if (arg == "--close-timeout" && i + 1 < argc) {
+            options.close_timeout = std::stoul(argv[++i]);
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--threads N] [--max-queue N] [--max-queue-bytes BYTES] [--overflow drop|disconnect]\n"
+                      << "       [--max-message BYTES] [--no-deflate] [--deflate-level 1-9] [--deflate-min-size BYTES]\n"
+                      << "       [--deflate-window-bits 9-15] [--deflate-context-takeover]\n"
+                      << "       [--ping-interval SECONDS] [--idle-timeout SECONDS] [--close-timeout SECONDS]\n"
+                      << "       [--history N] [--history-bytes BYTES] [--max-rooms N]\n";
+            return 2;
+        }
+    }
+
+    logger.start();
+
+    WebSocket_Server server(8080, options);
+    server.start();
+}